@@ -0,0 +1,286 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <glob.h>
+#include <sys/stat.h>
+#include "ConjunctiveNormalForm.hpp"
+
+// формат строк с результатами
+enum class BatchFormat {
+    Csv, // заголовок и строки через запятую
+    Json // по одному JSON объекту на строку
+};
+
+// настройки решения набора файлов
+struct BatchConfiguration {
+    DecisionStrategy strategy; // стратегия выбора литерала
+    bool useCDCL; // использовать ли обучение на конфликтах
+    RestartPolicy restartPolicy; // политика перезапусков
+    bool phaseSaving; // сохранять ли фазы
+    bool bitParallel; // решать ли DPLL небольших формул битовым движком
+    bool localSearch; // искать ли модель локальным поиском
+    LocalSearchOptions localSearchOptions; // настройки локального поиска
+    bool removeDuplicates; // удалять ли дубликаты при чтении
+    bool subsumption; // удалять ли включающие клаузы
+    bool probing; // заменять ли эквивалентные литералы и искать ли ложные литералы
+    bool elimination; // исключать ли переменные
+    SearchLimits limits; // ограничения поиска на каждый файл
+    BatchFormat format; // формат строк с результатами
+};
+
+// итоги решения набора файлов
+struct BatchSummary {
+    int sat; // число выполнимых формул
+    int unsat; // число невыполнимых формул
+    int unknown; // число формул без ответа в пределах ограничений
+    int errors; // число файлов, которые не удалось прочитать
+    double parseTime; // суммарное время чтения (мс)
+    double solveTime; // суммарное время решения (мс)
+    double wallTime; // общее время работы (мс)
+};
+
+// перевод названия формата в формат
+BatchFormat GetBatchFormat(const std::string &format) {
+    if (format == "csv")
+        return BatchFormat::Csv;
+
+    if (format == "json")
+        return BatchFormat::Json;
+
+    throw std::string("Invalid batch format '") + format + "'";
+}
+
+// решение формулы с настройками набора
+Verdict SolveWithConfiguration(ConjunctiveNormalForm &cnf, const BatchConfiguration &configuration) {
+    cnf.SetRestartPolicy(configuration.restartPolicy);
+    cnf.SetPhaseSaving(configuration.phaseSaving);
+    cnf.SetBitParallel(configuration.bitParallel);
+    cnf.SetLimits(configuration.limits);
+
+    if (configuration.localSearch)
+        return cnf.LocalSearch(configuration.localSearchOptions, configuration.strategy);
+
+    return configuration.useCDCL ? cnf.CDCL(configuration.strategy) : cnf.DPLL(configuration.strategy);
+}
+
+// список файлов по каталогу (все *.cnf) или шаблону пути
+std::vector<std::string> GetBatchFiles(const std::string &pattern) {
+    struct stat info;
+    std::string mask = pattern;
+
+    if (stat(pattern.c_str(), &info) == 0 && S_ISDIR(info.st_mode))
+        mask = pattern + (pattern.back() == '/' ? "*.cnf" : "/*.cnf");
+
+    glob_t matches;
+    std::vector<std::string> files;
+
+    if (glob(mask.c_str(), 0, nullptr, &matches) == 0) {
+        for (size_t i = 0; i < matches.gl_pathc; i++)
+            files.push_back(matches.gl_pathv[i]);
+    }
+
+    globfree(&matches);
+
+    if (files.empty())
+        throw std::string("no files match '") + pattern + "'";
+
+    return files;
+}
+
+// параллельное решение набора файлов: потоки чтения заполняют ограниченную очередь прочитанных формул, потоки решения её разбирают
+class BatchRunner {
+    // прочитанный файл, ожидающий решения
+    struct LoadedFile {
+        int index; // номер файла в списке
+        std::unique_ptr<ConjunctiveNormalForm> cnf; // формула (nullptr при ошибке чтения)
+        std::string error; // текст ошибки чтения
+        double parseTime; // время чтения (мс)
+    };
+
+    std::vector<std::string> files; // пути к файлам
+    BatchConfiguration configuration; // настройки решения
+    int threadsCount; // число потоков решения
+    int loadersCount; // число потоков чтения
+    size_t capacity; // наибольшее число прочитанных, но не решённых формул
+
+    std::deque<LoadedFile> loaded; // прочитанные формулы
+    std::mutex mutex; // защита очереди и итогов
+    std::condition_variable notEmpty; // в очереди появилась формула или чтение закончено
+    std::condition_variable notFull; // в очереди освободилось место
+    std::atomic<int> nextFile; // номер следующего файла для чтения
+    int activeLoaders; // число работающих потоков чтения
+
+    std::ostream *output; // поток для строк с результатами
+    std::mutex outputMutex; // защита вывода
+    BatchSummary summary; // итоги
+
+    void Load(); // работа потока чтения
+    void Solve(); // работа потока решения
+    void PrintHeader(); // заголовок CSV
+    void PrintResult(int index, const std::string &verdict, double parseTime, double solveTime, long long decisions); // вывод строки результата
+public:
+    BatchRunner(const std::vector<std::string> &files, const BatchConfiguration &configuration, int threadsCount);
+
+    BatchSummary Run(std::ostream &output); // решение всех файлов с выводом результатов по мере готовности
+};
+
+BatchRunner::BatchRunner(const std::vector<std::string> &files, const BatchConfiguration &configuration, int threadsCount) {
+    if (threadsCount <= 0)
+        throw std::string("BatchRunner: threads count must be positive");
+
+    this->files = files;
+    this->configuration = configuration;
+    this->threadsCount = threadsCount;
+
+    loadersCount = std::max(1, threadsCount / 4); // чтение обычно в разы быстрее решения
+    capacity = 2 * threadsCount; // запас, чтобы потоки решения не ждали чтения
+    output = nullptr;
+}
+
+// работа потока чтения
+void BatchRunner::Load() {
+    while (true) {
+        int index = nextFile.fetch_add(1);
+
+        if (index >= (int) files.size())
+            break;
+
+        LoadedFile file;
+        file.index = index;
+
+        std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+
+        try {
+            file.cnf.reset(new ConjunctiveNormalForm(files[index], configuration.removeDuplicates, configuration.subsumption, configuration.elimination, configuration.probing));
+        }
+        catch (const std::string &error) {
+            file.error = error;
+        }
+
+        file.parseTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - t0).count() / 1000.0;
+
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (loaded.size() >= capacity)
+            notFull.wait(lock);
+
+        loaded.push_back(std::move(file));
+        notEmpty.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (--activeLoaders == 0)
+        notEmpty.notify_all(); // больше формул не будет
+}
+
+// работа потока решения
+void BatchRunner::Solve() {
+    while (true) {
+        LoadedFile file;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (loaded.empty() && activeLoaders > 0)
+                notEmpty.wait(lock);
+
+            if (loaded.empty())
+                return;
+
+            file = std::move(loaded.front());
+            loaded.pop_front();
+            notFull.notify_one();
+        }
+
+        if (!file.cnf) {
+            PrintResult(file.index, "ERROR", file.parseTime, 0, 0);
+            std::cerr << "Error in '" << files[file.index] << "': " << file.error << std::endl; // текст ошибки отдельно от результатов
+
+            std::lock_guard<std::mutex> lock(mutex);
+            summary.errors++;
+            summary.parseTime += file.parseTime;
+            continue;
+        }
+
+        ConjunctiveNormalForm &cnf = *file.cnf;
+        std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+        Verdict verdict = SolveWithConfiguration(cnf, configuration);
+        double solveTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - t0).count() / 1000.0;
+
+        PrintResult(file.index, VerdictToString(verdict), file.parseTime, solveTime, cnf.GetSolverStatistics().decisions);
+        file.cnf.reset(); // освобождаем формулу до следующего задания
+
+        std::lock_guard<std::mutex> lock(mutex);
+        (verdict == Verdict::Sat ? summary.sat : verdict == Verdict::Unsat ? summary.unsat : summary.unknown)++;
+        summary.parseTime += file.parseTime;
+        summary.solveTime += solveTime;
+    }
+}
+
+// заголовок CSV
+void BatchRunner::PrintHeader() {
+    if (configuration.format == BatchFormat::Csv)
+        *output << "index,path,verdict,parse_ms,solve_ms,decisions" << std::endl;
+}
+
+// вывод строки результата
+void BatchRunner::PrintResult(int index, const std::string &verdict, double parseTime, double solveTime, long long decisions) {
+    const std::string &path = files[index];
+    bool isCsv = configuration.format == BatchFormat::Csv;
+    std::string escaped; // путь в кавычках: в CSV кавычка удваивается, в JSON экранируется
+
+    for (size_t i = 0; i < path.size(); i++) {
+        if (path[i] == '"')
+            escaped += isCsv ? '"' : '\\';
+        else if (path[i] == '\\' && !isCsv)
+            escaped += '\\';
+
+        escaped += path[i];
+    }
+
+    std::lock_guard<std::mutex> lock(outputMutex);
+
+    if (isCsv) {
+        *output << index << ",\"" << escaped << "\"," << verdict << "," << parseTime << "," << solveTime << "," << decisions << std::endl;
+        return;
+    }
+
+    *output << "{\"index\": " << index << ", \"path\": \"" << escaped << "\", \"verdict\": \"" << verdict << "\", \"parse_ms\": " << parseTime << ", \"solve_ms\": " << solveTime << ", \"decisions\": " << decisions << "}" << std::endl;
+}
+
+// решение всех файлов с выводом результатов по мере готовности
+BatchSummary BatchRunner::Run(std::ostream &output) {
+    this->output = &output;
+    summary = { 0, 0, 0, 0, 0, 0, 0 };
+    loaded.clear();
+    nextFile.store(0);
+    activeLoaders = loadersCount;
+
+    PrintHeader();
+
+    std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < loadersCount; i++)
+        threads.emplace_back(&BatchRunner::Load, this);
+
+    for (int i = 0; i < threadsCount; i++)
+        threads.emplace_back(&BatchRunner::Solve, this);
+
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    summary.wallTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - t0).count() / 1000.0;
+    return summary;
+}
@@ -0,0 +1,525 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include "Instrumentation.hpp"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// состояние клаузы при текущем присваивании
+enum class BitClauseState {
+    Satisfied, // есть истинный литерал
+    Unresolved, // не меньше двух неопределённых литералов
+    Unit, // один неопределённый литерал, остальные ложны
+    Empty // все литералы ложны
+};
+
+// решение битового поиска
+struct BitDecision {
+    int literal; // литерал решения (2 * номер бита + знак)
+    bool isSecondBranch; // перебирается ли уже вторая ветвь
+};
+
+// состояние клаузы по маскам (words слов положительных литералов, затем words слов отрицательных) и присваиванию,
+// для невыполненной клаузы в freeBits остаются биты неопределённых литералов (скалярный вариант)
+template <int words>
+BitClauseState GetBitClauseState(const uint64_t *clause, const uint64_t *trueBits, const uint64_t *falseBits, uint64_t *freeBits) {
+    uint64_t satisfied = 0;
+    uint64_t any = 0; // есть неопределённый литерал
+    uint64_t many = 0; // есть второй неопределённый литерал
+
+    for (int i = 0; i < words; i++) {
+        satisfied |= (clause[i] & trueBits[i]) | (clause[words + i] & falseBits[i]);
+        freeBits[i] = (clause[i] | clause[words + i]) & ~(trueBits[i] | falseBits[i]);
+        many |= (freeBits[i] & (freeBits[i] - 1)) | (any ? freeBits[i] : 0);
+        any |= freeBits[i];
+    }
+
+    if (satisfied)
+        return BitClauseState::Satisfied;
+
+    if (!any)
+        return BitClauseState::Empty;
+
+    return many ? BitClauseState::Unresolved : BitClauseState::Unit;
+}
+
+#if defined(__SSE2__)
+
+// нулевой ли 128-битный вектор
+inline bool IsZeroVector(__m128i vector) {
+#if defined(__SSE4_1__)
+    return _mm_testz_si128(vector, vector);
+#else
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(vector, _mm_setzero_si128())) == 0xFFFF;
+#endif
+}
+
+// состояние клаузы до 128 переменных (SSE)
+template <>
+inline BitClauseState GetBitClauseState<2>(const uint64_t *clause, const uint64_t *trueBits, const uint64_t *falseBits, uint64_t *freeBits) {
+    __m128i positive = _mm_loadu_si128((const __m128i*) clause);
+    __m128i negative = _mm_loadu_si128((const __m128i*) (clause + 2));
+    __m128i trueVector = _mm_load_si128((const __m128i*) trueBits);
+    __m128i falseVector = _mm_load_si128((const __m128i*) falseBits);
+
+    if (!IsZeroVector(_mm_or_si128(_mm_and_si128(positive, trueVector), _mm_and_si128(negative, falseVector))))
+        return BitClauseState::Satisfied;
+
+    __m128i free = _mm_andnot_si128(_mm_or_si128(trueVector, falseVector), _mm_or_si128(positive, negative));
+    _mm_store_si128((__m128i*) freeBits, free);
+
+    if (IsZeroVector(free))
+        return BitClauseState::Empty;
+
+    // в одном из слов больше одного бита
+    if (!IsZeroVector(_mm_and_si128(free, _mm_sub_epi64(free, _mm_set1_epi64x(1)))))
+        return BitClauseState::Unresolved;
+
+    return freeBits[0] && freeBits[1] ? BitClauseState::Unresolved : BitClauseState::Unit;
+}
+
+#endif
+
+#if defined(__SSE2__) && !defined(__AVX2__)
+
+// состояние клаузы до 256 переменных (SSE, по половинам масок)
+template <>
+inline BitClauseState GetBitClauseState<4>(const uint64_t *clause, const uint64_t *trueBits, const uint64_t *falseBits, uint64_t *freeBits) {
+    __m128i positive[2] = { _mm_loadu_si128((const __m128i*) clause), _mm_loadu_si128((const __m128i*) (clause + 2)) };
+    __m128i negative[2] = { _mm_loadu_si128((const __m128i*) (clause + 4)), _mm_loadu_si128((const __m128i*) (clause + 6)) };
+    __m128i trueVector[2] = { _mm_load_si128((const __m128i*) trueBits), _mm_load_si128((const __m128i*) (trueBits + 2)) };
+    __m128i falseVector[2] = { _mm_load_si128((const __m128i*) falseBits), _mm_load_si128((const __m128i*) (falseBits + 2)) };
+    __m128i satisfied = _mm_setzero_si128();
+    __m128i free[2];
+
+    for (int i = 0; i < 2; i++) {
+        satisfied = _mm_or_si128(satisfied, _mm_or_si128(_mm_and_si128(positive[i], trueVector[i]), _mm_and_si128(negative[i], falseVector[i])));
+        free[i] = _mm_andnot_si128(_mm_or_si128(trueVector[i], falseVector[i]), _mm_or_si128(positive[i], negative[i]));
+        _mm_store_si128((__m128i*) (freeBits + 2 * i), free[i]);
+    }
+
+    if (!IsZeroVector(satisfied))
+        return BitClauseState::Satisfied;
+
+    if (IsZeroVector(_mm_or_si128(free[0], free[1])))
+        return BitClauseState::Empty;
+
+    __m128i ones = _mm_set1_epi64x(1);
+    __m128i lowest = _mm_or_si128(_mm_and_si128(free[0], _mm_sub_epi64(free[0], ones)), _mm_and_si128(free[1], _mm_sub_epi64(free[1], ones)));
+
+    if (!IsZeroVector(lowest))
+        return BitClauseState::Unresolved;
+
+    int nonZero = (freeBits[0] != 0) + (freeBits[1] != 0) + (freeBits[2] != 0) + (freeBits[3] != 0);
+    return nonZero > 1 ? BitClauseState::Unresolved : BitClauseState::Unit;
+}
+
+#endif
+
+#if defined(__AVX2__)
+
+// состояние клаузы до 256 переменных (AVX2)
+template <>
+inline BitClauseState GetBitClauseState<4>(const uint64_t *clause, const uint64_t *trueBits, const uint64_t *falseBits, uint64_t *freeBits) {
+    __m256i positive = _mm256_loadu_si256((const __m256i*) clause);
+    __m256i negative = _mm256_loadu_si256((const __m256i*) (clause + 4));
+    __m256i trueVector = _mm256_load_si256((const __m256i*) trueBits);
+    __m256i falseVector = _mm256_load_si256((const __m256i*) falseBits);
+    __m256i satisfied = _mm256_or_si256(_mm256_and_si256(positive, trueVector), _mm256_and_si256(negative, falseVector));
+
+    if (!_mm256_testz_si256(satisfied, satisfied))
+        return BitClauseState::Satisfied;
+
+    __m256i free = _mm256_andnot_si256(_mm256_or_si256(trueVector, falseVector), _mm256_or_si256(positive, negative));
+    _mm256_store_si256((__m256i*) freeBits, free);
+
+    if (_mm256_testz_si256(free, free))
+        return BitClauseState::Empty;
+
+    __m256i lowest = _mm256_and_si256(free, _mm256_sub_epi64(free, _mm256_set1_epi64x(1)));
+
+    if (!_mm256_testz_si256(lowest, lowest))
+        return BitClauseState::Unresolved;
+
+    // по одному биту в словах, единична только при одном ненулевом слове
+    int nonZero = ~_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(free, _mm256_setzero_si256()))) & 15;
+
+    return nonZero & (nonZero - 1) ? BitClauseState::Unresolved : BitClauseState::Unit;
+}
+
+#endif
+
+// набор инструкций, которым проверяются клаузы формулы из заданного числа переменных
+std::string BitParallelInstructionSet(int variablesCount) {
+    if (variablesCount <= 64)
+        return "scalar, 1 word";
+
+#if defined(__AVX2__)
+    return variablesCount <= 128 ? "SSE2, 2 words" : "AVX2, 4 words";
+#elif defined(__SSE2__)
+    return variablesCount <= 128 ? "SSE2, 2 words" : "SSE2, 4 words";
+#else
+    return variablesCount <= 128 ? "scalar, 2 words" : "scalar, 4 words";
+#endif
+}
+
+// DPLL для формул не больше чем из 256 переменных: клаузы - пары масок положительных и отрицательных литералов,
+// присваивание - маски истинных и ложных переменных, состояние клаузы вычисляется несколькими векторными операциями без обхода литералов
+class BitParallelSolver {
+public:
+    static const int MAX_VARIABLES = 256; // наибольшее число переменных
+private:
+    int variablesCount; // число переменных
+    int words; // 64-битных слов в маске (1, 2 или 4)
+    std::vector<uint64_t> masks; // маски клауз подряд (words слов положительных литералов, затем words слов отрицательных)
+    int clausesCount; // число клауз
+    std::vector<int> literals; // литералы клауз подряд (2 * номер бита + знак) для подсчёта оценок
+    std::vector<int> literalStarts; // начала клауз в literals (на одно больше, чем клауз)
+    bool hasEmptyClause; // есть ли пустая клауза
+    std::vector<int> occurrenceStarts; // начала списков вхождений по кодам литералов (2 * номер бита + знак)
+    std::vector<int> occurrences; // номера клауз, содержащих литерал, подряд по кодам литералов
+
+    alignas(32) uint64_t trueBits[4]; // истинные переменные
+    alignas(32) uint64_t falseBits[4]; // ложные переменные
+    alignas(32) uint64_t freeBits[4]; // неопределённые литералы последней проверенной клаузы
+    std::vector<int> queue; // присвоенные и ещё не распространённые литералы
+    size_t queueHead; // первый нераспространённый литерал очереди
+    std::vector<BitDecision> decisions; // решения
+    std::vector<uint64_t> savedBits; // маски присваивания перед каждым решением
+    std::vector<int> activeClauses; // списки невыполненных клауз подряд: все клаузы, затем невыполненные перед каждым решением
+    std::vector<size_t> activeStarts; // начала списков (на один больше, чем решений)
+    std::vector<double> scores; // оценки литералов при выборе решения
+    std::vector<double> sizeWeights; // веса клауз по числу неопределённых литералов
+
+    void FillOccurrences(); // построение списков вхождений по маскам клауз
+    void Assign(int literal); // присваивание литералу истинного значения
+    int GetUnitLiteral() const; // единственный неопределённый литерал клаузы по freeBits
+
+    template <int W>
+    bool Propagate(long long &conflicts, long long &propagations, InstrumentationStatistics &instrumentation); // распространение констант по спискам вхождений (false при конфликте)
+
+    template <int W>
+    int GetDecisionLiteral(InstrumentationStatistics &instrumentation); // литерал с наибольшей взвешенной суммой по невыполненным клаузам (-1, если все клаузы выполнены)
+
+    template <int W>
+    bool Search(long long &decisionsCount, long long &conflicts, long long &propagations, InstrumentationStatistics &instrumentation, const std::function<bool()> &stop); // поиск с заданным числом слов в маске
+public:
+    BitParallelSolver(int variablesCount, int expectedClausesCount = 0);
+
+    void AddClause(const int *clause, int size); // добавление клаузы (коды литералов 2 * переменная + знак)
+    bool Solve(long long &decisions, long long &conflicts, long long &propagations, InstrumentationStatistics &instrumentation, const std::function<bool()> &stop); // поиск модели (false, если формула невыполнима или stop вернул true)
+    bool GetValue(int variable) const; // значение переменной в найденной модели (неопределённые - ложь)
+};
+
+BitParallelSolver::BitParallelSolver(int variablesCount, int expectedClausesCount) {
+    if (variablesCount > MAX_VARIABLES)
+        throw std::string("BitParallelSolver: too many variables (") + std::to_string(variablesCount) + ")";
+
+    this->variablesCount = variablesCount;
+    words = variablesCount <= 64 ? 1 : (variablesCount <= 128 ? 2 : 4);
+    clausesCount = 0;
+    hasEmptyClause = false;
+    masks.reserve((size_t) expectedClausesCount * 2 * words);
+    literalStarts.reserve(expectedClausesCount + 1);
+    literalStarts.push_back(0);
+    scores.resize(2 * variablesCount);
+    sizeWeights.resize(variablesCount + 1);
+
+    for (int i = 0; i <= variablesCount; i++)
+        sizeWeights[i] = std::ldexp(1.0, -i);
+}
+
+// добавление клаузы (коды литералов 2 * переменная + знак)
+void BitParallelSolver::AddClause(const int *clause, int size) {
+    size_t offset = masks.size();
+    masks.resize(offset + 2 * words, 0);
+
+    for (int i = 0; i < size; i++) {
+        int literal = clause[i] - 2; // переменные нумеруются с нуля
+        int bit = literal >> 1;
+
+        masks[offset + (literal & 1) * words + bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+
+    // тавтология всегда выполнена и не участвует в поиске
+    for (int i = 0; i < words; i++) {
+        if (masks[offset + i] & masks[offset + words + i]) {
+            masks.resize(offset);
+            return;
+        }
+    }
+
+    if (size == 0)
+        hasEmptyClause = true;
+
+    for (int i = 0; i < size; i++)
+        literals.push_back(clause[i] - 2);
+
+    literalStarts.push_back(literals.size());
+    clausesCount++;
+}
+
+// построение списков вхождений по маскам клауз
+void BitParallelSolver::FillOccurrences() {
+    occurrenceStarts.assign(2 * variablesCount + 1, 0);
+
+    // два прохода по битам масок: число вхождений литералов, затем номера клауз
+    for (int pass = 0; pass < 2; pass++) {
+        std::vector<int> positions(occurrenceStarts.begin(), occurrenceStarts.end() - 1);
+
+        for (int i = 0; i < clausesCount; i++) {
+            for (int j = 0; j < 2 * words; j++) {
+                for (uint64_t bits = masks[2 * words * i + j]; bits; bits &= bits - 1) {
+                    int literal = 2 * (64 * (j % words) + __builtin_ctzll(bits)) + j / words;
+
+                    if (pass == 0)
+                        occurrenceStarts[literal + 1]++;
+                    else
+                        occurrences[positions[literal]++] = i;
+                }
+            }
+        }
+
+        if (pass == 0) {
+            for (int literal = 0; literal < 2 * variablesCount; literal++)
+                occurrenceStarts[literal + 1] += occurrenceStarts[literal];
+
+            occurrences.resize(occurrenceStarts.back());
+        }
+    }
+}
+
+// присваивание литералу истинного значения
+void BitParallelSolver::Assign(int literal) {
+    int bit = literal >> 1;
+    uint64_t *bits = literal & 1 ? falseBits : trueBits;
+
+    bits[bit / 64] |= uint64_t(1) << (bit % 64);
+    queue.push_back(literal);
+}
+
+// единственный неопределённый литерал клаузы по freeBits
+int BitParallelSolver::GetUnitLiteral() const {
+    int word = 0;
+
+    while (!freeBits[word])
+        word++;
+
+    return 2 * (64 * word + __builtin_ctzll(freeBits[word])); // знак определяет вызывающий по маске отрицательных литералов
+}
+
+// распространение констант по спискам вхождений (false при конфликте)
+template <int W>
+bool BitParallelSolver::Propagate(long long &conflicts, long long &propagations, InstrumentationStatistics &instrumentation) {
+    INSTRUMENT_SCOPE(instrumentation, PropagationPhase);
+
+    while (queueHead < queue.size()) {
+        int falseLiteral = queue[queueHead++] ^ 1; // клаузы, где литерал стал ложным
+        const int *end = occurrences.data() + occurrenceStarts[falseLiteral + 1];
+
+        for (const int *it = occurrences.data() + occurrenceStarts[falseLiteral]; it != end; it++) {
+            const uint64_t *clause = masks.data() + 2 * W * *it;
+            INSTRUMENT(instrumentation.clauseVisits++);
+
+            BitClauseState state = GetBitClauseState<W>(clause, trueBits, falseBits, freeBits);
+
+            if (state == BitClauseState::Empty) {
+                conflicts++;
+                return false;
+            }
+
+            if (state == BitClauseState::Unit) {
+                int literal = GetUnitLiteral();
+                int bit = literal >> 1;
+
+                if (clause[W + bit / 64] & (uint64_t(1) << (bit % 64)))
+                    literal |= 1; // неопределённый литерал входит в клаузу с отрицанием
+
+                Assign(literal);
+                propagations++;
+            }
+        }
+    }
+
+    return true;
+}
+
+// литерал с наибольшей взвешенной суммой по невыполненным клаузам (-1, если все клаузы выполнены)
+template <int W>
+int BitParallelSolver::GetDecisionLiteral(InstrumentationStatistics &instrumentation) {
+    INSTRUMENT_SCOPE(instrumentation, DecisionPhase);
+    std::fill(scores.begin(), scores.end(), 0.0);
+
+    // выполненная клауза остаётся выполненной глубже по дереву: смотрим только невыполненные перед предыдущим решением
+    // и дописываем в конец невыполненные сейчас (список нового решения)
+    size_t begin = activeStarts.back();
+    size_t end = activeClauses.size();
+    activeClauses.resize(end + (end - begin)); // новый список не длиннее предыдущего
+    int *active = activeClauses.data() + end;
+    uint64_t assigned[W];
+
+    for (int j = 0; j < W; j++)
+        assigned[j] = trueBits[j] | falseBits[j];
+
+    for (size_t k = begin; k < end; k++) {
+        int i = activeClauses[k];
+        const uint64_t *clause = masks.data() + 2 * W * i;
+        uint64_t satisfied = 0;
+
+        for (int j = 0; j < W; j++)
+            satisfied |= (clause[j] & trueBits[j]) | (clause[W + j] & falseBits[j]);
+
+        if (satisfied)
+            continue; // после распространения остальные клаузы содержат не меньше двух неопределённых литералов
+
+        *active++ = i;
+
+        // неопределённые литералы по списку литералов клаузы: число шагов не зависит от присваивания и хорошо предсказывается
+        const int *first = literals.data() + literalStarts[i];
+        const int *last = literals.data() + literalStarts[i + 1];
+        int size = 0;
+
+        for (const int *it = first; it != last; it++)
+            size += !((assigned[*it >> 7] >> ((*it >> 1) & 63)) & 1);
+
+        double weight = sizeWeights[size];
+
+        for (const int *it = first; it != last; it++)
+            scores[*it] += ((assigned[*it >> 7] >> ((*it >> 1) & 63)) & 1) ? 0 : weight;
+    }
+
+    activeClauses.resize(active - activeClauses.data());
+
+    if (activeClauses.size() == end)
+        return -1;
+
+    // переменная с наибольшим произведением оценок литералов, ветвь - литерал с большей оценкой
+    int literal = -1;
+    double best = -1;
+
+    for (int i = 0; i < 2 * variablesCount; i += 2) {
+        if (scores[i] == 0 && scores[i + 1] == 0)
+            continue;
+
+        double score = 1024 * scores[i] * scores[i + 1] + scores[i] + scores[i + 1];
+
+        if (score > best) {
+            best = score;
+            literal = scores[i] >= scores[i + 1] ? i : i + 1;
+        }
+    }
+
+    return literal;
+}
+
+// поиск с заданным числом слов в маске
+template <int W>
+bool BitParallelSolver::Search(long long &decisionsCount, long long &conflicts, long long &propagations, InstrumentationStatistics &instrumentation, const std::function<bool()> &stop) {
+    if (hasEmptyClause)
+        return false;
+
+    // единичные клаузы присваиваются до распространения, противоречие между ними - пустая клауза при проверке
+    for (int i = 0; i < clausesCount; i++) {
+        const uint64_t *clause = masks.data() + 2 * W * i;
+        BitClauseState state = GetBitClauseState<W>(clause, trueBits, falseBits, freeBits);
+
+        if (state == BitClauseState::Empty) {
+            conflicts++;
+            return false;
+        }
+
+        if (state == BitClauseState::Unit) {
+            int literal = GetUnitLiteral();
+            int bit = literal >> 1;
+
+            Assign(literal | ((clause[W + bit / 64] >> (bit % 64)) & 1));
+            propagations++;
+        }
+    }
+
+    while (true) {
+        if (stop())
+            return false;
+
+        if (!Propagate<W>(conflicts, propagations, instrumentation)) {
+            INSTRUMENT_SCOPE(instrumentation, BacktrackPhase);
+            INSTRUMENT(instrumentation.backtracks++);
+
+            while (!decisions.empty() && decisions.back().isSecondBranch) {
+                decisions.pop_back();
+                savedBits.resize(savedBits.size() - 2 * W);
+                activeClauses.resize(activeStarts.back());
+                activeStarts.pop_back();
+            }
+
+            if (decisions.empty())
+                return false; // обе ветви всех решений привели к конфликту
+
+            // восстанавливаем присваивание до решения и пробуем вторую ветвь
+            const uint64_t *saved = savedBits.data() + savedBits.size() - 2 * W;
+            std::memcpy(trueBits, saved, W * sizeof(uint64_t));
+            std::memcpy(falseBits, saved + W, W * sizeof(uint64_t));
+            queue.clear();
+            queueHead = 0;
+
+            decisions.back().isSecondBranch = true;
+            Assign(decisions.back().literal ^ 1);
+            continue;
+        }
+
+        size_t start = activeClauses.size();
+        int literal = GetDecisionLiteral<W>(instrumentation);
+
+        if (literal < 0)
+            return true; // все клаузы выполнены
+
+        activeStarts.push_back(start);
+        decisionsCount++;
+        savedBits.insert(savedBits.end(), trueBits, trueBits + W);
+        savedBits.insert(savedBits.end(), falseBits, falseBits + W);
+        decisions.push_back({ literal, false });
+        INSTRUMENT(instrumentation.maxDepth = std::max(instrumentation.maxDepth, (int) decisions.size()));
+
+        queue.clear();
+        queueHead = 0;
+        Assign(literal);
+    }
+}
+
+// поиск модели (false, если формула невыполнима или stop вернул true)
+bool BitParallelSolver::Solve(long long &decisions, long long &conflicts, long long &propagations, InstrumentationStatistics &instrumentation, const std::function<bool()> &stop) {
+    std::memset(trueBits, 0, sizeof(trueBits));
+    std::memset(falseBits, 0, sizeof(falseBits));
+    queue.clear();
+    queueHead = 0;
+    this->decisions.clear();
+    savedBits.clear();
+    activeClauses.resize(clausesCount);
+    activeStarts.assign(1, 0);
+    FillOccurrences();
+
+    for (int i = 0; i < clausesCount; i++)
+        activeClauses[i] = i;
+
+    if (words == 1)
+        return Search<1>(decisions, conflicts, propagations, instrumentation, stop);
+
+    if (words == 2)
+        return Search<2>(decisions, conflicts, propagations, instrumentation, stop);
+
+    return Search<4>(decisions, conflicts, propagations, instrumentation, stop);
+}
+
+// значение переменной в найденной модели (неопределённые - ложь)
+bool BitParallelSolver::GetValue(int variable) const {
+    int bit = variable - 1;
+    return (trueBits[bit / 64] >> (bit % 64)) & 1;
+}
@@ -1,17 +1,27 @@
 #pragma once
 
 #include <iostream>
-#include <sstream>
 #include <iomanip>
 #include <vector>
 #include <stack>
+#include <queue>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
+#include <cstdint>
 #include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <functional>
+#include "VariableHeap.hpp"
+#include "DimacsReader.hpp"
+#include "Instrumentation.hpp"
+#include "ProofWriter.hpp"
+#include "BitParallelSolver.hpp"
+#include "LocalSearchSolver.hpp"
 
 // значения термов
-enum class TermValue {
+enum class TermValue : unsigned char {
     Undefined,
     True,
     False
@@ -25,7 +35,43 @@ enum class DecisionStrategy {
     Moms, // вхождения в минимальные клаузы
     Weighted, // взвешенная сумму
     Up, // стратегия UP
-    AUPC
+    AUPC,
+    Vsids, // активность переменных в конфликтах (EVSIDS)
+    LookAhead // пробное распространение обеих фаз переменных-кандидатов
+};
+
+// политика перезапусков
+enum class RestartPolicy {
+    None, // без перезапусков
+    Luby, // интервалы по последовательности Луби
+    Geometric, // геометрически растущие интервалы
+    Glucose // по скользящему среднему LBD выученных клауз (только CDCL)
+};
+
+// результат поиска
+enum class Verdict {
+    Sat, // выполнима
+    Unsat, // невыполнима
+    Unknown // поиск остановлен до ответа
+};
+
+// причина остановки поиска без ответа
+enum class StopReason {
+    None, // поиск не останавливался
+    Interrupt, // внешний флаг остановки
+    TimeLimit, // исчерпано время
+    ConflictLimit, // исчерпаны конфликты
+    DecisionLimit, // исчерпаны разветвления
+    MemoryLimit, // база клауз превысила допустимый объём
+    FlipLimit // исчерпан бюджет переворотов локального поиска
+};
+
+// ограничения одного вызова поиска (0 - без ограничения)
+struct SearchLimits {
+    double time; // время (с)
+    long long conflicts; // число конфликтов
+    long long decisions; // число разветвлений
+    size_t memory; // объём базы клауз (байт)
 };
 
 struct Assignment {
@@ -34,54 +80,310 @@ struct Assignment {
     TermValue value;
 };
 
+// заголовок клаузы в общем массиве литералов
+struct Clause {
+    int offset; // позиция первого литерала
+    int size; // число литералов
+};
+
+// бинарная клауза в списке импликаций литерала: когда литерал становится ложным, второй литерал должен стать истинным
+struct BinaryImplication {
+    int literal; // второй литерал клаузы
+    int clause; // номер клаузы (причина присваивания)
+};
+
+// оценки выученной клаузы
+struct LearnedClause {
+    int lbd; // число различных уровней решений в клаузе (glue)
+    double activity; // активность в недавних конфликтах
+};
+
+// статистика предобработки
+struct PreprocessingStatistics {
+    int duplicates; // удалено повторяющихся клауз
+    int tautologies; // удалено тавтологий
+    int subsumed; // удалено поглощённых клауз
+    int strengthened; // усилено клауз самопоглощающей резолюцией (по одному литералу)
+    double subsumptionTime; // время поглощения (мс)
+    int eliminatedVariables; // исключено переменных
+    int eliminatedClauses; // на сколько уменьшилось число клауз при исключении переменных
+    double eliminationTime; // время исключения переменных (мс)
+    int equivalentVariables; // заменено переменных эквивалентными литералами
+    int failedLiterals; // найдено ложных литералов при пробах
+    int fixedVariables; // зафиксировано переменных на нулевом уровне при пробах
+    double probingTime; // время проб и замены эквивалентных литералов (мс)
+};
+
+// статистика поиска
+struct SolverStatistics {
+    long long decisions; // число разветвлений
+    long long conflicts; // число конфликтов
+    long long propagations; // число присваиваний при распространении констант
+    long long restarts; // число перезапусков
+    long long savedPhaseDecisions; // число разветвлений по сохранённой фазе
+    long long learnedClauses; // число выученных клауз
+    long long deletedClauses; // число удалённых выученных клауз
+    long long reductions; // число чисток базы выученных клауз
+    size_t peakDatabaseBytes; // наибольший объём базы клауз (байт)
+    long long lookAheads; // число пробных распространений при просмотре вперёд
+    long long failedLiterals; // число литералов, опровергнутых пробным распространением
+    long long flips; // число переворотов переменных локальным поиском
+};
+
+// литералы внутри решателя кодируются как 2 * переменная + знак (1 для отрицания)
 class ConjunctiveNormalForm {
     int literalsCount; // количество литералов
     int clausesCount; // количество клауз
-    std::vector<std::vector<int>> clauses; // клаузы
+    std::vector<int> literals; // литералы всех клауз подряд
+    std::vector<Clause> clauses; // клаузы (сначала исходные, затем выученные)
+    int originalClausesCount; // число исходных клауз
+    std::vector<LearnedClause> learnedClauses; // оценки выученных клауз (по номеру клаузы - originalClausesCount)
     std::vector<TermValue> values; // значения термов
-    std::unordered_map<int, int> up;
-    std::unordered_map<int, std::vector<int>> l2c;
+    std::vector<TermValue> literalValues; // значения литералов по их кодам
+    std::vector<int> up; // число распространений переменной
+    std::vector<std::vector<int>> l2c; // списки клауз по кодам литералов
+    std::vector<std::vector<int>> watches; // списки наблюдаемых клауз по кодам литералов (клаузы из трёх и более литералов)
+    std::vector<std::vector<BinaryImplication>> implications; // бинарные клаузы по кодам литералов, хранятся вместе со вторым литералом
+    std::vector<int> hashTable; // открытая хеш-таблица номеров клауз для удаления дубликатов при чтении (-1 - пусто)
+    std::vector<uint64_t> clauseHashes; // хеши добавленных клауз
+    PreprocessingStatistics preprocessing; // статистика предобработки
+    std::vector<bool> eliminated; // исключённые при предобработке переменные
+    std::vector<int> eliminationStack; // клаузы исключённых переменных для восстановления модели (исключаемый литерал, остальные литералы, размер)
+    std::queue<int> propagationQueue; // очередь литералов для распространения
+
+    int level; // текущий уровень решений
+    int conflictClause; // клауза, на которой обнаружен последний конфликт
+    std::vector<int> levels; // уровни решений, на которых назначены переменные
+    std::vector<int> reasons; // клаузы-причины назначений (-1 для решений)
+    std::vector<bool> seen; // отметки переменных при анализе конфликта
+
+    VariableHeap vsids; // куча переменных по активности
+    double activityIncrement; // текущая величина увеличения активности
+    const double activityDecay = 0.95; // коэффициент затухания активности
+
+    RestartPolicy restartPolicy; // политика перезапусков
+    long long conflictsSinceRestart; // число конфликтов после последнего перезапуска
+    double restartLimit; // число конфликтов до следующего перезапуска (Luby, Geometric)
+    double fastLBD; // быстрое скользящее среднее LBD
+    double lbdSum; // сумма LBD всех выученных клауз
+    std::vector<int> levelStamps; // отметки уровней при подсчёте LBD
+    int levelStamp; // текущая отметка уровней
+    const int restartInterval = 100; // базовый интервал перезапусков в конфликтах
+    const double restartGrowth = 1.5; // множитель геометрических интервалов
+    const double fastLBDDecay = 1.0 / 32; // вес нового значения в быстром среднем LBD
+    const double glucoseFactor = 0.8; // перезапуск, если быстрое среднее * K больше общего
+    const int glucoseMinConflicts = 50; // минимальное число конфликтов между перезапусками glucose
+
+    double clauseActivityIncrement; // текущая величина увеличения активности клауз
+    const double clauseActivityDecay = 0.999; // коэффициент затухания активности клауз
+    long long nextReduction; // число конфликтов до следующей чистки базы
+    const int reduceInterval = 2000; // конфликтов до первой чистки
+    const int reduceIncrement = 300; // увеличение интервала после каждой чистки
+    const int glueLBD = 2; // клаузы с LBD не больше этого никогда не удаляются
+    const double probingBudget = 1000; // бюджет времени проб и замены эквивалентных литералов (мс)
+
+    bool phaseSaving; // запоминать ли последние значения переменных
+    std::vector<TermValue> savedPhases; // последние значения переменных
+    SolverStatistics statistics; // статистика поиска
+    InstrumentationStatistics instrumentation; // счётчики и таймеры горячих участков (только с -DSOLVER_INSTRUMENTATION)
+    long long progressInterval; // число конфликтов между строками прогресса (0 - без прогресса)
+    std::chrono::steady_clock::time_point searchStart; // момент начала поиска
+
+    std::mt19937 generator; // генератор случайных чисел (свой у каждой копии формулы)
+    const std::atomic<bool> *interruptFlag; // внешний флаг остановки поиска (nullptr, если не задан)
+    StopReason stopReason; // почему последний поиск остановлен без ответа
+    SearchLimits limits; // ограничения поиска
+    std::chrono::steady_clock::time_point deadline; // момент исчерпания времени
+    int limitCheckCountdown; // итераций до следующей проверки времени и памяти
+    const int limitCheckInterval = 1024; // проверять время и память раз в столько итераций поиска
+    int assumptionsLevel; // число уровней, занятых предположениями (не перебираются и не сбрасываются перезапуском)
+    const std::atomic<bool> *splitFlag; // запрос другого потока на часть дерева поиска (nullptr, если не задан)
+    std::function<void(const std::vector<int>&)> splitHandler; // получатель отданных кубов
+
+    std::vector<std::vector<int>> pendingClauses; // клаузы, добавленные после чтения и ещё не подключённые к поиску
+    size_t assumptionIndex; // первое предположение, которое может быть ещё не выставлено (CDCL)
+    std::vector<int> failedAssumptions; // предположения, противоречие которых доказано последним поиском
+
+    ProofWriter *proof; // запись доказательства DRAT (nullptr, если не ведётся)
+    std::vector<int> proofClause; // буфер клаузы для записи в доказательство
+
+    bool learning; // идёт ли поиск с обучением (CDCL): опровергнутый литерал нельзя присвоить без клаузы-причины
+    std::vector<int> lookAheadCandidates; // переменные-кандидаты просмотра вперёд
+    std::stack<int> lookAheadTrail; // след пробного распространения
+    std::vector<int> lookAheadLiterals; // литералы, присвоенные пробным распространением
+    std::vector<int> lookAheadStamps; // отметки клауз, уже учтённых в оценке пробного распространения
+    int lookAheadStamp; // текущая отметка клауз
+    const int lookAheadMinCandidates = 10; // наименьшее число кандидатов просмотра вперёд
+    const double lookAheadFraction = 0.1; // доля неопределённых переменных среди кандидатов
+    const double lookAheadDecay = 0.2; // во сколько раз вес сокращённой клаузы меньше на каждый лишний литерал
+
+    bool bitParallel; // решать ли DPLL небольших формул битовым движком
+    bool bitParallelUsed; // решён ли последний поиск битовым движком
+
+    bool useCounters; // поддерживаются ли счётчики вхождений для статических стратегий
+    int maxClauseSize; // наибольший размер клаузы, учтённый в счётчиках
+    std::vector<std::vector<int>> variableClauses; // клаузы, содержащие переменную
+    std::vector<int> occurrences; // число вхождений переменной в невыполненные клаузы
+    std::vector<int> sizeOccurrences; // число вхождений переменной в невыполненные клаузы текущего размера (size * (literalsCount + 1) + variable)
+    std::vector<double> weights; // сумма 2^-size по невыполненным клаузам с переменной
+    std::vector<int> sizeClauses; // число невыполненных клауз по текущему размеру
+    std::vector<double> sizeWeights; // веса 2^-size клауз по размеру
+    std::vector<int> clauseSizes; // текущие размеры клауз (число неопределённых литералов)
+    std::vector<int> clauseTrueCounts; // число истинных литералов в клаузах
+    std::vector<TermValue> countedValues; // значения переменных, по которым посчитаны счётчики
+    std::vector<int> changedVariables; // переменные, изменённые с последней синхронизации счётчиков
+    std::vector<bool> isChangedVariable; // отметки изменённых переменных
+    std::vector<int> touchedClauses; // клаузы, пересчитываемые при синхронизации
+    std::vector<bool> isTouchedClause; // отметки пересчитываемых клауз
 
     void SetLiteralsCount(int literalsCount); // обновление количества литералов
     void SetClausesCount(int clausesCount); // обновление количества клауз
-    void AddClause(const std::string& line, bool removeDuplicates); // добавление клаузы
+    void Load(DimacsReader &reader, bool removeDuplicates, bool subsumption, bool elimination, bool probing, bool reloading); // чтение и предобработка формулы (при повторном чтении память сохраняется)
+    void ReadHeader(DimacsReader &reader); // чтение строки "p cnf"
+    void AddClause(int offset, bool removeDuplicates); // добавление клаузы из литералов, записанных в конец массива с позиции offset
+    void AppendClause(const std::vector<int> &clause); // запись клаузы в общий массив литералов
+    int NormalizeClause(int *clause, int size) const; // сортировка и удаление повторов литералов (-1 для тавтологии)
+    uint64_t GetClauseHash(const int *clause, int size) const; // хеш отсортированной клаузы
+    void InsertClauseHash(int clause, uint64_t hash); // добавление клаузы в хеш-таблицу
+    bool ContainsClause(const int *clause, int size, uint64_t hash) const; // есть ли уже такая клауза
+    void RemoveClauses(const std::vector<bool> &removed); // удаление отмеченных клауз с уплотнением массива литералов
+    void FillOccurrenceLists(); // заполнение списков клауз по литералам
     void FillWatchLists(); // заполнение вотчлистов
 
-    bool IsInclude(const std::vector<int> clause1, const std::vector<int> clause2) const; // проверка, что первое множество входит во второе
-    void Subsumption(); // удаление клауз, содержащих меньшие клаузы
-
+    uint64_t GetClauseSignature(size_t clause) const; // 64-битная сигнатура переменных клаузы
+    int CheckSubsumption(size_t clause1, size_t clause2) const; // поглощает ли первая клауза вторую (-1), позволяет ли удалить литерал из неё (код литерала) или нет (-2)
+    void StrengthenClause(size_t clause, int literal); // удаление литерала из клаузы
+    void Subsumption(); // удаление поглощённых клауз и самопоглощающая резолюция
+
+    void AddEmptyClause(); // добавление пустой клаузы при доказанной при предобработке невыполнимости
+    bool FindEquivalentLiterals(std::vector<int> &representatives) const; // компоненты сильной связности графа импликаций бинарных клауз (false, если x и NOT x эквивалентны)
+    int SubstituteEquivalentLiterals(const std::vector<int> &representatives, std::vector<bool> &removed); // замена литералов представителями классов эквивалентности
+    bool ProbeFailedLiterals(const std::chrono::steady_clock::time_point &deadline); // пробы литералов на нулевом уровне (false при противоречии)
+    int SimplifyByRootAssignments(std::vector<bool> &removed); // удаление выполненных клауз и ложных литералов по присваиваниям нулевого уровня
+    void Probing(); // пробы литералов и замена эквивалентных литералов
+
+    bool Resolve(size_t clause1, size_t clause2, int variable, std::vector<int> &resolvent) const; // резольвента двух клауз по переменной (false для тавтологии)
+    bool EliminateVariable(int variable, std::vector<bool> &removed, std::vector<std::vector<int>> &resolvents); // исключение переменной резолюцией, если число клауз не растёт
+    void VariableElimination(); // ограниченное исключение переменных
+    void ExtendModel(); // восстановление значений исключённых переменных
+    void SetExternalModel(const std::function<bool(int)> &getValue); // перенос модели другого решателя с восстановлением исключённых переменных
+
+    int* GetClauseLiterals(size_t index); // литералы клаузы
+    const int* GetClauseLiterals(size_t index) const; // литералы клаузы
     TermValue GetLiteralValue(int literal) const; // получение значения литерала
-    int GetClauseSize(size_t index) const; // получкение размера клаузы
-    bool IsUnitClause(size_t index) const; // является ли клауза единичной
-    bool IsRemovedClause(size_t index) const; // удалена ли клауза (есть ли единичные литералы)
-    bool IsEmptyClause(size_t index) const; // пустая ли клауза
-
-    int GetUnitLiteral(size_t index) const; // получение литерала из единичной клаузы
-    void PropagateLiteral(size_t clause, std::stack<int> &assignments); // распространение константы
-    bool UnitPropagation(std::stack<int> &assignments); // распространение констант
 
-    bool IsConflict(int literal) const; // есть ли пустые клаузы
+    std::vector<int>& GetWatchList(int literal); // список клауз, наблюдающих литерал
+    void WatchClause(int clause); // подключение клаузы к распространению: бинарной - к спискам импликаций, длинной - к спискам наблюдения
+    void InitCounters(); // построение счётчиков вхождений
+    void ResizeCounters(int clauseSize); // расширение счётчиков под клаузы большего размера
+    void AddClauseToCounters(size_t clause); // добавление клаузы в счётчики вхождений
+    void RecountClause(size_t clause); // пересчёт размера клаузы и числа истинных литералов
+    void UpdateClauseCounters(size_t clause, int sign); // учёт (+1) или снятие (-1) вклада клаузы в счётчики
+    void SyncCounters(); // обновление счётчиков по переменным, изменённым с последней синхронизации
+    void SetValue(int variable, TermValue value); // изменение значения переменной с отметкой для счётчиков
+    void AssignLiteral(int literal, int reason); // присваивание литералу истинного значения
+    void UnassignLiteral(int literal); // сброс значения литерала
+    void PropagateLiteral(int literal, int reason, std::stack<int> &assignments); // распространение константы
+    bool AssignUnitClauses(std::stack<int> &assignments); // присваивание литералов исходных единичных клауз
+    bool UnitPropagation(std::stack<int> &assignments); // распространение констант до неподвижной точки (false при конфликте)
 
     int GetFirstUndefinedLiteral() const; // первый неопределённый литерал
-    int GetRandomUndefinedLiteral() const; // случайный неопределённый литерал
+    int GetRandomUndefinedLiteral(); // случайный неопределённый литерал
     int GetMaxOccurencesLiteral() const; // литерал с наибольшим числом вхождений
+    int GetMaxSizeOccurencesLiteral(int size) const; // литерал с наибольшим числом вхождений в клаузы заданного размера
     int GetMomsOccurencesLiteral() const; // литерал с наибольшим числом вхождений в кратчайшие клаузы
     int GetWeightedLiteral() const; // литерал по взвешенной сумме
     int GetUpLiteral() const; // литерал по стратегии Up
     int GetAUPCLiteral() const; // литерал по стратегии AUPC
-    int GetDecisionLiteral(DecisionStrategy strategy) const; // выбор литерала для разветвления
+    int GetVsidsLiteral(); // литерал с наибольшей активностью
+    void SelectLookAheadCandidates(); // отбор переменных-кандидатов для просмотра вперёд
+    double ProbeLiteral(int literal); // пробное распространение литерала: оценка сокращённых клауз (-1 при конфликте)
+    int GetLookAheadLiteral(std::stack<int> &assignments, std::stack<Assignment> &decisions); // литерал по просмотру вперёд (0, если присвоено отрицание опровергнутого литерала)
+    int GetDecisionVariable(DecisionStrategy strategy); // выбор переменной для разветвления
+    int GetDecisionLiteral(DecisionStrategy strategy); // выбор литерала для разветвления (кроме просмотра вперёд)
+
+    void BumpVariable(int variable); // увеличение активности переменной
+    void BumpClause(int clause); // увеличение активности переменных клаузы
+    void DecayActivity(); // экспоненциальное затухание активностей
+
+    int GetLBD(const std::vector<int> &clause); // число различных уровней решений в клаузе
+    void InitSearch(); // сброс статистики и состояния перезапусков перед поиском
+    bool CheckInterrupt(); // проверка внешнего флага остановки и ограничений поиска
+    void ResetAssignments(); // сброс всех присваиваний перед новым поиском
+    void AssignAssumption(int literal, std::stack<int> &assignments, std::stack<Assignment> &decisions); // присваивание предположения на новом уровне
+    bool AssignAssumptions(const std::vector<int> &assumptions, std::stack<int> &assignments, std::stack<Assignment> &decisions); // присваивание предположений на отдельных уровнях (false при противоречии)
+    void AnalyzeFinal(int literal, std::stack<int> &assignments); // поиск предположений, из которых следует отрицание предположения literal
+    void GrowVariables(int variablesCount); // расширение структур под новые переменные
+    void AttachPendingClauses(); // подключение добавленных клауз перед выученными
+    bool DonateSubtree(std::stack<Assignment> &decisions); // отдача ближайшей к корню неисследованной ветви
+    void AddConflict(int lbd); // учёт конфликта для перезапусков (lbd = 0, если клауза не выучена)
+    void PrintProgress() const; // строка прогресса в поток ошибок
+    void WriteDecisionsClause(std::stack<Assignment> decisions); // запись в доказательство отрицания решений (DPLL)
+    bool NeedRestart() const; // пора ли перезапускаться
+    void Restart(std::stack<int> &assignments, std::stack<Assignment> &decisions); // перезапуск: откат на нулевой уровень
 
     bool RollBack(std::stack<int> &assignments, std::stack<Assignment> &decisions); // откат
     void Decision(std::stack<int> &assignments, std::stack<Assignment> &decisions, DecisionStrategy strategy); // разветвление
+
+    int AnalyzeConflict(std::stack<int> &assignments, std::vector<int> &learned); // анализ конфликта по первой точке доминирования (1-UIP)
+    void BackJump(std::stack<int> &assignments, std::stack<Assignment> &decisions, int backjumpLevel); // нехронологический откат
+    void LearnClause(const std::vector<int> &learned, std::stack<int> &assignments, int lbd); // добавление выученной клаузы
+    void BumpClauseActivity(int clause); // увеличение активности выученной клаузы
+    size_t GetDatabaseBytes() const; // объём базы клауз (байт)
+    bool NeedReduce() const; // пора ли чистить базу выученных клауз
+    void ReduceDatabase(); // удаление худшей половины выученных клауз
+
+    bool CanUseBitParallel(const std::vector<int> &assumptions) const; // можно ли решить DPLL битовым движком
+    Verdict BitParallelDPLL(); // DPLL битовым движком по исходным клаузам
 public:
-    ConjunctiveNormalForm(std::istream &fin, bool removeDuplicates = false, bool subsumption = false);
+    ConjunctiveNormalForm(DimacsReader &reader, bool removeDuplicates = false, bool subsumption = false, bool elimination = false, bool probing = false, ProofWriter *proof = nullptr);
+    ConjunctiveNormalForm(std::istream &fin, bool removeDuplicates = false, bool subsumption = false, bool elimination = false, bool probing = false, ProofWriter *proof = nullptr);
+    ConjunctiveNormalForm(const std::string &path, bool removeDuplicates = false, bool subsumption = false, bool elimination = false, bool probing = false, ProofWriter *proof = nullptr);
+
+    void Reload(DimacsReader &reader, bool removeDuplicates = false, bool subsumption = false, bool elimination = false, bool probing = false, ProofWriter *proof = nullptr); // чтение новой формулы в тот же объект (массивы сохраняют выделенную память)
 
     void Print() const; // вывод СКНФ
     void PrintTermValues() const; // вывод значений термов
-
-    bool DPLL(DecisionStrategy strategy); // алгоритм DPLL
+    const PreprocessingStatistics& GetPreprocessingStatistics() const; // статистика предобработки
+    const SolverStatistics& GetSolverStatistics() const; // статистика поиска
+    const InstrumentationStatistics& GetInstrumentationStatistics() const; // счётчики и таймеры горячих участков
+
+    void SetRestartPolicy(RestartPolicy policy); // установка политики перезапусков
+    void SetPhaseSaving(bool phaseSaving); // включение сохранения фаз
+    void SetBitParallel(bool bitParallel); // решать ли DPLL формул до 256 переменных битовым движком (включено по умолчанию)
+    void SetSeed(unsigned seed); // установка зерна генератора случайных чисел
+    void SetProgressInterval(long long conflicts); // печать строки прогресса каждые conflicts конфликтов (0 - выключено)
+    void SetProofWriter(ProofWriter *proof); // запись доказательства следующих вызовов поиска (nullptr - без доказательства)
+    void SetLimits(const SearchLimits &limits); // установка ограничений для следующих вызовов поиска
+    const SearchLimits& GetLimits() const; // ограничения поиска
+    void SetInterruptFlag(const std::atomic<bool> *flag); // установка флага для кооперативной остановки поиска
+    void SetSplitHandler(const std::atomic<bool> *flag, std::function<void(const std::vector<int>&)> handler); // установка запроса и получателя частей дерева поиска DPLL
+    int GetVariablesCount() const; // число переменных
+    int GetOccurrencesCount(int variable) const; // число вхождений переменной в исходные клаузы
+    bool WasInterrupted() const; // был ли последний поиск остановлен без ответа
+    StopReason GetStopReason() const; // почему последний поиск остановлен без ответа
+    bool WasBitParallel() const; // решён ли последний поиск битовым движком
+
+    Verdict DPLL(DecisionStrategy strategy, const std::vector<int> &assumptions = std::vector<int>()); // алгоритм DPLL (при предположениях - коды литералов)
+    Verdict CDCL(DecisionStrategy strategy, const std::vector<int> &assumptions = std::vector<int>()); // алгоритм CDCL (обучение на конфликтах, при предположениях - коды литералов)
+    Verdict LocalSearch(const LocalSearchOptions &options, DecisionStrategy strategy = DecisionStrategy::First); // локальный поиск модели (при hybrid после исчерпания бюджета - DPLL со стратегией strategy)
+
+    void AddClause(const std::vector<int> &clause); // добавление клаузы (литералы в формате DIMACS) между вызовами поиска
+    Verdict Solve(const std::vector<int> &assumptions = std::vector<int>(), DecisionStrategy strategy = DecisionStrategy::Vsids); // инкрементальный CDCL при предположениях (литералы в формате DIMACS)
+    const std::vector<int>& GetFailedAssumptions() const; // противоречивое подмножество предположений последнего Solve (формат DIMACS)
+    TermValue GetTermValue(int variable) const; // значение переменной в найденной модели
 };
 
+// кодирование литерала из формата DIMACS
+int EncodeLiteral(int literal) {
+    return literal > 0 ? 2 * literal : 1 - 2 * literal;
+}
+
+// декодирование литерала в формат DIMACS
+int DecodeLiteral(int literal) {
+    return literal & 1 ? -(literal >> 1) : literal >> 1;
+}
+
 // перевод стратегии в строку
 std::string StrategyToString(DecisionStrategy strategy) {
     if (strategy == DecisionStrategy::First)
@@ -105,9 +407,107 @@ std::string StrategyToString(DecisionStrategy strategy) {
     if (strategy == DecisionStrategy::AUPC)
         return "aupc";
 
+    if (strategy == DecisionStrategy::Vsids)
+        return "vsids";
+
+    if (strategy == DecisionStrategy::LookAhead)
+        return "lookahead";
+
+    return "";
+}
+
+// последовательность Луби: 1, 1, 2, 1, 1, 2, 4, ... (y = 2)
+double Luby(double y, int x) {
+    int size = 1;
+    int sequence = 0;
+
+    while (size < x + 1) {
+        sequence++;
+        size = 2 * size + 1;
+    }
+
+    while (size - 1 != x) {
+        size = (size - 1) >> 1;
+        sequence--;
+        x = x % size;
+    }
+
+    return std::pow(y, sequence);
+}
+
+// перевод результата поиска в строку
+std::string VerdictToString(Verdict verdict) {
+    if (verdict == Verdict::Sat)
+        return "SAT";
+
+    if (verdict == Verdict::Unsat)
+        return "UNSAT";
+
+    return "UNKNOWN";
+}
+
+// перевод причины остановки в строку
+std::string StopReasonToString(StopReason reason) {
+    if (reason == StopReason::Interrupt)
+        return "interrupted";
+
+    if (reason == StopReason::TimeLimit)
+        return "time limit";
+
+    if (reason == StopReason::ConflictLimit)
+        return "conflict limit";
+
+    if (reason == StopReason::DecisionLimit)
+        return "decision limit";
+
+    if (reason == StopReason::MemoryLimit)
+        return "memory limit";
+
+    if (reason == StopReason::FlipLimit)
+        return "flip limit";
+
+    return "none";
+}
+
+// перевод политики перезапусков в строку
+std::string RestartPolicyToString(RestartPolicy policy) {
+    if (policy == RestartPolicy::None)
+        return "none";
+
+    if (policy == RestartPolicy::Luby)
+        return "luby";
+
+    if (policy == RestartPolicy::Geometric)
+        return "geometric";
+
+    if (policy == RestartPolicy::Glucose)
+        return "glucose";
+
     return "";
 }
 
+// получение политики перезапусков
+RestartPolicy GetRestartPolicy(const std::string& policy) {
+    if (policy == "none")
+        return RestartPolicy::None;
+
+    if (policy == "luby")
+        return RestartPolicy::Luby;
+
+    if (policy == "geometric")
+        return RestartPolicy::Geometric;
+
+    if (policy == "glucose")
+        return RestartPolicy::Glucose;
+
+    throw std::string("Invalid restart policy '") + policy + "'";
+}
+
+// использует ли стратегия счётчики вхождений литералов в клаузы
+bool IsCountingStrategy(DecisionStrategy strategy) {
+    return strategy == DecisionStrategy::Max || strategy == DecisionStrategy::Moms || strategy == DecisionStrategy::Weighted || strategy == DecisionStrategy::AUPC || strategy == DecisionStrategy::LookAhead;
+}
+
 // получение стратегии
 DecisionStrategy GetStrategy(const std::string& strategy) {
     if (strategy == "first")
@@ -131,44 +531,174 @@ DecisionStrategy GetStrategy(const std::string& strategy) {
     if (strategy == "aupc")
         return DecisionStrategy::AUPC;
 
+    if (strategy == "vsids")
+        return DecisionStrategy::Vsids;
+
+    if (strategy == "lookahead")
+        return DecisionStrategy::LookAhead;
+
     throw std::string("Invalid strategy name '") + strategy + "'";
 }
 
-ConjunctiveNormalForm::ConjunctiveNormalForm(std::istream &fin, bool removeDuplicates, bool subsumption) {
+ConjunctiveNormalForm::ConjunctiveNormalForm(DimacsReader &reader, bool removeDuplicates, bool subsumption, bool elimination, bool probing, ProofWriter *proof) {
+    this->proof = proof; // удаления при чтении и предобработке тоже попадают в доказательство
+    Load(reader, removeDuplicates, subsumption, elimination, probing, false);
+}
+
+ConjunctiveNormalForm::ConjunctiveNormalForm(std::istream &fin, bool removeDuplicates, bool subsumption, bool elimination, bool probing, ProofWriter *proof) {
+    DimacsReader reader(fin);
+    this->proof = proof;
+    Load(reader, removeDuplicates, subsumption, elimination, probing, false);
+}
+
+ConjunctiveNormalForm::ConjunctiveNormalForm(const std::string &path, bool removeDuplicates, bool subsumption, bool elimination, bool probing, ProofWriter *proof) {
+    DimacsReader reader(path);
+    this->proof = proof;
+    Load(reader, removeDuplicates, subsumption, elimination, probing, false);
+}
+
+// чтение новой формулы в тот же объект (массивы сохраняют выделенную память)
+void ConjunctiveNormalForm::Reload(DimacsReader &reader, bool removeDuplicates, bool subsumption, bool elimination, bool probing, ProofWriter *proof) {
+    // Load дописывает клаузы в конец массивов, остальное состояние он задаёт сам
+    literals.clear();
+    clauses.clear();
+    learnedClauses.clear();
+    pendingClauses.clear();
+    failedAssumptions.clear();
+    propagationQueue = std::queue<int>();
+    std::fill(hashTable.begin(), hashTable.end(), -1); // таблица остаётся выделенной, но хеши прошлой формулы стираются
+    clauseHashes.clear();
+    this->proof = proof;
+    Load(reader, removeDuplicates, subsumption, elimination, probing, true);
+}
+
+// чтение и предобработка формулы
+void ConjunctiveNormalForm::Load(DimacsReader &reader, bool removeDuplicates, bool subsumption, bool elimination, bool probing, bool reloading) {
     this->literalsCount = 0;
     this->clausesCount = 0;
+    preprocessing = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    int offset = 0; // начало текущей клаузы в массиве литералов
+    int literal;
+
+    while (true) {
+        reader.SkipSpaces();
+        int symbol = reader.Peek();
+
+        if (symbol == EOF || symbol == '%')
+            break; // конец данных (в файлах SATLIB за '%' следует служебный 0)
+
+        if (symbol == 'c') {
+            reader.SkipLine(); // игнорируем строки с комментариями
+            continue;
+        }
+
+        if (symbol == 'p') {
+            ReadHeader(reader);
+            continue;
+        }
 
-    std::string line;
+        if (!reader.ReadInt(literal))
+            throw std::string("Invalid file: unexpected symbol '") + (char) symbol + "'";
 
-    while (std::getline(fin, line) && line != "0") {
-        if (line == "" || line[0] == 'c' || line[0] == '%')
-            continue; // игнорируем пустые строки и строки с комментариями
+        if (literal == 0) { // клауза может занимать несколько строк и заканчивается нулём
+            if (offset == literals.size() && clauses.size() == clausesCount)
+                break; // одиночный 0 после всех объявленных клауз - конец данных, а не пустая клауза
 
-        if (line[0] == 'p') {
-            std::string tmp;
-            std::stringstream ss(line);
-            ss >> tmp >> tmp >> literalsCount >> clausesCount;
-            SetLiteralsCount(literalsCount);
-            SetClausesCount(clausesCount);
+            AddClause(offset, removeDuplicates);
+            offset = literals.size();
             continue;
         }
 
-        AddClause(line, removeDuplicates);
+        if (abs(literal) > literalsCount)
+            throw std::string("Invalid literal index '") + std::to_string(literal) + "'";
+
+        literals.push_back(EncodeLiteral(literal)); // литералы пишутся сразу в общий массив
+    }
+
+    if (offset != literals.size())
+        AddClause(offset, removeDuplicates); // последняя клауза без завершающего нуля
+
+    if (!reloading) { // хеши после чтения не нужны, а при повторном чтении таблица пригодится следующей формуле
+        std::vector<int>().swap(hashTable);
+        std::vector<uint64_t>().swap(clauseHashes);
     }
 
     if (clauses.size() != clausesCount)
         throw std::string("Invalid file: different clauses count");
 
-    values = std::vector<TermValue>(literalsCount + 1, TermValue::Undefined); // значения литералов не определены
+    values.assign(literalsCount + 1, TermValue::Undefined); // значения литералов не определены
+    literalValues.assign(2 * literalsCount + 2, TermValue::Undefined);
+    levels.assign(literalsCount + 1, 0);
+    reasons.assign(literalsCount + 1, -1);
+    seen.assign(literalsCount + 1, false);
+    level = 0;
+    conflictClause = -1;
+
+    useCounters = false;
+    maxClauseSize = 0;
+
+    vsids.Reset(literalsCount); // память кучи сохраняется между формулами
+    activityIncrement = 1;
+
+    for (int i = 1; i <= literalsCount; i++)
+        vsids.Insert(i);
+
+    restartPolicy = RestartPolicy::None;
+    levelStamps.assign(literalsCount + 1, 0);
+    levelStamp = 0;
+    phaseSaving = false;
+    savedPhases.assign(literalsCount + 1, TermValue::Undefined);
+    statistics = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    instrumentation = InstrumentationStatistics();
+    progressInterval = 0;
+    interruptFlag = nullptr;
+    stopReason = StopReason::None;
+    limits = { 0, 0, 0, 0 };
+    assumptionsLevel = 0;
+    splitFlag = nullptr;
+    assumptionIndex = 0;
+    bitParallel = true;
+    bitParallelUsed = false;
+
+    eliminated.assign(literalsCount + 1, false);
+    eliminationStack.clear();
+    up.assign(literalsCount + 1, 0);
 
     if (subsumption) {
         Subsumption();
     }
 
-    for (int i = 1; i <= literalsCount; i++)
-        up[i] = 0;
+    if (probing) {
+        Probing();
+    }
+
+    if (elimination) {
+        VariableElimination();
+    }
 
     FillWatchLists();
+    originalClausesCount = clauses.size();
+    learning = false;
+    lookAheadStamps.assign(originalClausesCount, 0);
+    lookAheadStamp = 0;
+}
+
+// чтение строки "p cnf"
+void ConjunctiveNormalForm::ReadHeader(DimacsReader &reader) {
+    int literalsCount;
+    int clausesCount;
+
+    reader.Skip(); // p
+    reader.SkipSpaces();
+    reader.SkipWord(); // cnf
+
+    if (!reader.ReadInt(literalsCount) || !reader.ReadInt(clausesCount))
+        throw std::string("Invalid file: incorrect problem line");
+
+    reader.SkipLine();
+    SetLiteralsCount(literalsCount);
+    SetClausesCount(clausesCount);
 }
 
 // обновление количества литералов
@@ -186,429 +716,1933 @@ void ConjunctiveNormalForm::SetClausesCount(int clausesCount) {
 
     this->clausesCount = clausesCount;
     clauses.reserve(clausesCount);
+    literals.reserve(clausesCount * 3);
 }
 
-// добавление клаузы
-void ConjunctiveNormalForm::AddClause(const std::string& line, bool removeDuplicates) {
-    std::stringstream ss(line);
-    std::vector<int> clause;
-    int literal;
-
-    while (ss >> literal && literal != 0) {
-        if (literal == 0 || abs(literal) > literalsCount)
-            throw std::string("Invalid literal index at line '") + line + "'";
-
-        clause.push_back(literal); // добавляем литералы в клаузу
-    }
+// добавление клаузы из литералов, записанных в конец массива с позиции offset
+void ConjunctiveNormalForm::AddClause(int offset, bool removeDuplicates) {
+    int size = literals.size() - offset;
 
     if (removeDuplicates) {
-        std::sort(clause.begin(), clause.end());
+        size = NormalizeClause(literals.data() + offset, size);
+        uint64_t hash = size < 0 ? 0 : GetClauseHash(literals.data() + offset, size);
 
-        if (std::find(clauses.begin(), clauses.end(), clause) == clauses.end()) {
-            clauses.push_back(clause); // добавляем клаузу
-        }
-        else {
+        if (size < 0 || ContainsClause(literals.data() + offset, size, hash)) {
+            if (proof != nullptr) // нормализация переставляет литералы, но множество литералов не меняет
+                proof->DeleteClause(literals.data() + offset, literals.size() - offset);
+
+            literals.resize(offset); // тавтология или такая клауза уже есть
             clausesCount--;
+
+            if (size < 0) {
+                preprocessing.tautologies++;
+            }
+            else {
+                preprocessing.duplicates++;
+            }
+
+            return;
         }
-    }
-    else {
-        clauses.push_back(clause); // добавляем клаузу
-    }
-}
 
-// заполнение вотчлистов
-void ConjunctiveNormalForm::FillWatchLists() {
-    for (int i = 1; i <= literalsCount; i++) {
-        l2c[i] = std::vector<int>();
-        l2c[-i] = std::vector<int>();
+        literals.resize(offset + size);
+        InsertClauseHash(clauses.size(), hash);
     }
 
-    for (size_t i = 0; i < clauses.size(); i++)
-        for (auto j = clauses[i].begin(); j != clauses[i].end(); j++)
-            l2c[*j].push_back(i);
+    clauses.push_back({ offset, size }); // добавляем клаузу
 }
 
-// проверка, что первое множество входит во второе
-bool ConjunctiveNormalForm::IsInclude(const std::vector<int> clause1, const std::vector<int> clause2) const {
-    if (clause1.size() > clause2.size())
-        return false;
-
-    for (auto it1 = clause1.begin(); it1 != clause1.end(); it1++)
-        if (!std::binary_search(clause2.begin(), clause2.end(), *it1))
-            return false;
+// сортировка и удаление повторов литералов, возвращает новый размер (-1 для тавтологии)
+int ConjunctiveNormalForm::NormalizeClause(int *clause, int size) const {
+    std::sort(clause, clause + size);
 
-    return true;
-}
+    int index = 0;
 
-// удаление клауз, содержащих меньшие клаузы
-void ConjunctiveNormalForm::Subsumption() {
-    std::unordered_set<size_t> stays;
+    for (int i = 0; i < size; i++) {
+        if (index > 0 && clause[i] == clause[index - 1])
+            continue; // повторный литерал
 
-    for (size_t i = 0; i < clauses.size(); i++)
-        stays.insert(i);
+        if (index > 0 && clause[i] == (clause[index - 1] ^ 1))
+            return -1; // x и NOT x стоят рядом после сортировки
 
-    for (size_t i = 0; i < clauses.size(); i++)
-        for (size_t j = 0; j < clauses.size(); j++)
-            if (i != j && IsInclude(clauses[i], clauses[j]))
-                stays.erase(j);
+        clause[index++] = clause[i];
+    }
 
-    if (stays.size() == clauses.size())
-        return;
+    return index;
+}
 
-    size_t index = 0;
+// хеш отсортированной клаузы
+uint64_t ConjunctiveNormalForm::GetClauseHash(const int *clause, int size) const {
+    uint64_t hash = size;
 
-    for (size_t i = 0; i < clauses.size(); i++)
-        if (stays.find(i) != stays.end())
-            clauses[index++] = clauses[i];
+    for (int i = 0; i < size; i++)
+        hash = (hash ^ (uint64_t) clause[i]) * 0x9E3779B97F4A7C15ull;
 
-    clauses.resize(index);
+    return hash ^ (hash >> 32); // младшие биты используются как индекс таблицы
 }
 
-// вывод СКНФ
-void ConjunctiveNormalForm::Print() const {
-    std::cout << "Literals count: " << literalsCount << std::endl;
-    std::cout << "Clauses count: " << clausesCount << std::endl;
-    std::cout << "Clauses:" << std::endl;
-
-    bool wasPrinted = false;
+// запись клаузы в общий массив литералов
+void ConjunctiveNormalForm::AppendClause(const std::vector<int> &clause) {
+    clauses.push_back({ (int) literals.size(), (int) clause.size() });
+    literals.insert(literals.end(), clause.begin(), clause.end());
+}
 
-    for (int i = 0; i < clausesCount; i++) {
-        if (wasPrinted)
-            std::cout << "  AND" << std::endl;
+// добавление клаузы в хеш-таблицу
+void ConjunctiveNormalForm::InsertClauseHash(int clause, uint64_t hash) {
+    if (2 * (clauseHashes.size() + 1) > hashTable.size()) { // держим заполнение не выше половины
+        std::vector<int> table(std::max((size_t) 1024, 4 * clauseHashes.size()), -1);
 
-        std::cout << "  (";
+        for (size_t i = 0; i < clauseHashes.size(); i++) {
+            size_t position = clauseHashes[i] & (table.size() - 1);
 
-        for (auto it = clauses[i].begin(); it != clauses[i].end(); it++) {
-            if (it != clauses[i].begin()) {
-                std::cout << " OR ";
-            }
+            while (table[position] >= 0)
+                position = (position + 1) & (table.size() - 1);
 
-            if (*it < 0) {
-                std::cout << "NOT x" << (-*it);
-            }
-            else {
-                std::cout << "x" << *it;
-            }
+            table[position] = i;
         }
 
-        std::cout << ")" << std::endl;
-        wasPrinted = true;
+        hashTable.swap(table);
     }
-}
 
-// вывод значений термов
-void ConjunctiveNormalForm::PrintTermValues() const {
-    std::cout << "+------------+-----------+" << std::endl;
-    std::cout << "|    term    |   value   |" << std::endl;
-    std::cout << "+------------+-----------+" << std::endl;
+    size_t position = hash & (hashTable.size() - 1);
 
-    for (size_t i = 1; i <= values.size(); i++) {
-        std::cout << "| " << std::setw(10) << ("x" + std::to_string(i + 1)) << " | " << std::setw(9);
+    while (hashTable[position] >= 0)
+        position = (position + 1) & (hashTable.size() - 1);
 
-        switch (values[i]) {
-            case TermValue::Undefined:
-                std::cout << "undefined";
-                break;
+    hashTable[position] = clause;
+    clauseHashes.push_back(hash);
+}
 
-            case TermValue::True:
-                std::cout << "true";
-                break;
+// есть ли уже такая клауза (сравниваются только клаузы с совпадающим хешем)
+bool ConjunctiveNormalForm::ContainsClause(const int *clause, int size, uint64_t hash) const {
+    if (hashTable.empty())
+        return false;
 
-            case TermValue::False:
-                std::cout << "false";
-                break;
-        }
+    size_t position = hash & (hashTable.size() - 1);
 
-        std::cout << " |" << std::endl;
+    for (; hashTable[position] >= 0; position = (position + 1) & (hashTable.size() - 1)) {
+        int index = hashTable[position];
+
+        if (clauseHashes[index] == hash && clauses[index].size == size && std::equal(clause, clause + size, GetClauseLiterals(index)))
+            return true;
     }
 
-    std::cout << "+------------+-----------+" << std::endl;
+    return false;
 }
 
-// получение значения литерала
-TermValue ConjunctiveNormalForm::GetLiteralValue(int literal) const {
-    size_t index = abs(literal);
+// удаление отмеченных клауз с уплотнением массива литералов
+void ConjunctiveNormalForm::RemoveClauses(const std::vector<bool> &removed) {
+    size_t index = 0;
+    int offset = 0;
+
+    for (size_t i = 0; i < clauses.size(); i++) {
+        if (removed[i])
+            continue;
 
-    if (literal > 0 || values[index] == TermValue::Undefined)
-        return values[index];
+        Clause clause = clauses[i];
+        std::copy(literals.begin() + clause.offset, literals.begin() + clause.offset + clause.size, literals.begin() + offset);
+        clauses[index++] = { offset, clause.size };
+        offset += clause.size;
+    }
 
-    return values[index] == TermValue::True ? TermValue::False : TermValue::True;
+    clauses.resize(index);
+    literals.resize(offset);
 }
 
-// получкение размера клаузы
-int ConjunctiveNormalForm::GetClauseSize(size_t index) const {
-    int size = 0;
+// заполнение списков клауз по литералам
+void ConjunctiveNormalForm::FillOccurrenceLists() {
+    std::vector<int> counts(2 * literalsCount + 2, 0);
 
-    for (auto it = clauses[index].begin(); it != clauses[index].end(); it++)
-        if (values[abs(*it)] == TermValue::Undefined)
-            size++;
+    for (auto it = literals.begin(); it != literals.end(); it++)
+        counts[*it]++;
 
-    return size;
-}
+    l2c.resize(2 * literalsCount + 2);
 
-// является ли клауза единичной
-bool ConjunctiveNormalForm::IsUnitClause(size_t index) const {
-    int undefinedCount = 0; // количество неопределённых значений
+    for (size_t i = 0; i < l2c.size(); i++) {
+        l2c[i].clear(); // списки сохраняют память прошлых заполнений
+        l2c[i].reserve(counts[i]); // один раз выделяем память под списки
+    }
 
-    for (auto it = clauses[index].begin(); it != clauses[index].end() && undefinedCount < 2; it++)
-        if (GetLiteralValue(*it) == TermValue::Undefined)
-            undefinedCount++;
+    for (size_t i = 0; i < clauses.size(); i++) {
+        const int *clause = GetClauseLiterals(i);
 
-    return undefinedCount == 1; // ровно один неопределённый литерал
+        for (int j = 0; j < clauses[i].size; j++)
+            l2c[clause[j]].push_back(i);
+    }
 }
 
-// удалена ли клауза (есть ли единичные литералы)
-bool ConjunctiveNormalForm::IsRemovedClause(size_t index) const {
-    for (auto it = clauses[index].begin(); it != clauses[index].end(); it++)
-        if (GetLiteralValue(*it) == TermValue::True)
-            return true;
+// заполнение вотчлистов
+void ConjunctiveNormalForm::FillWatchLists() {
+    FillOccurrenceLists();
 
-    return false;
-}
+    watches.resize(2 * literalsCount + 2);
+    implications.resize(2 * literalsCount + 2);
 
-// пустая ли клауза
-bool ConjunctiveNormalForm::IsEmptyClause(size_t index) const {
-    for (auto it = clauses[index].begin(); it != clauses[index].end(); it++)
-        if (GetLiteralValue(*it) != TermValue::False)
-            return false;
+    for (size_t i = 0; i < watches.size(); i++) { // списки сохраняют память прошлых заполнений
+        watches[i].clear();
+        implications[i].clear();
+    }
 
-    return true; // пуста, если все значения ложны
+    // единичные клаузы обрабатываются отдельно
+    for (size_t i = 0; i < clauses.size(); i++)
+        WatchClause(i);
 }
 
-// получение литерала из единичной клаузы
-int ConjunctiveNormalForm::GetUnitLiteral(size_t index) const {
-    for (auto it = clauses[index].begin(); it != clauses[index].end(); it++)
-        if (GetLiteralValue(*it) == TermValue::Undefined)
-            return *it;
+// 64-битная сигнатура переменных клаузы
+uint64_t ConjunctiveNormalForm::GetClauseSignature(size_t clause) const {
+    const int *clauseLiterals = GetClauseLiterals(clause);
+    uint64_t signature = 0;
 
-    throw std::string("GetUnitLiteral: clause is not unit");
+    for (int i = 0; i < clauses[clause].size; i++)
+        signature |= 1ull << ((clauseLiterals[i] >> 1) & 63);
+
+    return signature;
 }
 
-// распространение константы
-void ConjunctiveNormalForm::PropagateLiteral(size_t clause, std::stack<int> &assignments) {
-    int literal = GetUnitLiteral(clause);
-    TermValue value = literal > 0 ? TermValue::True : TermValue::False;
-    up[abs(literal)]++;
+// поглощает ли первая клауза вторую (-1), позволяет ли удалить литерал из неё (код литерала) или нет (-2)
+int ConjunctiveNormalForm::CheckSubsumption(size_t clause1, size_t clause2) const {
+    const int *literals1 = GetClauseLiterals(clause1);
+    const int *literals2 = GetClauseLiterals(clause2);
+    int size2 = clauses[clause2].size;
+    int result = -1;
+    int j = 0;
 
-    values[abs(literal)] = value;
-    assignments.push(literal);
-}
+    // клаузы отсортированы, поэтому x и NOT x стоят рядом и идём по обеим за один проход
+    for (int i = 0; i < clauses[clause1].size; i++) {
+        int variable = literals1[i] >> 1;
 
-// распространение констант
-bool ConjunctiveNormalForm::UnitPropagation(std::stack<int> &assignments) {
-    for (size_t i = 0; i < clauses.size(); i++) {
-        if (!IsRemovedClause(i) && IsUnitClause(i)) {
-            PropagateLiteral(i, assignments);
-            return true;
-        }
-    }
+        while (j < size2 && (literals2[j] >> 1) < variable)
+            j++;
 
-    return false;
-}
+        if (j == size2 || (literals2[j] >> 1) != variable)
+            return -2;
 
-// есть ли пустые клаузы
-bool ConjunctiveNormalForm::IsConflict(int literal) const {
-    for (auto i = l2c.at(literal).begin(); i != l2c.at(literal).end(); i++)
-        if (IsEmptyClause(*i))
-            return true; // конфликт
+        if (literals2[j] != literals1[i]) {
+            if (result != -1)
+                return -2; // противоположных литералов больше одного
 
-    return false; // пустых клауз нет
-}
+            result = literals2[j];
+        }
 
-// первый неопределённый литерал
-int ConjunctiveNormalForm::GetFirstUndefinedLiteral() const {
-    for (int i = 1; i <= literalsCount; i++)
-        if (values[i] == TermValue::Undefined)
-            return i;
+        j++;
+    }
 
-    return 0; // нет неопределённых литералов
+    return result;
 }
 
-// случайный неопределённый литерал
-int ConjunctiveNormalForm::GetRandomUndefinedLiteral() const {
-    std::vector<int> undefinedLiterals;
-
-    for (int i = 1; i <= literalsCount; i++)
-        if (values[i] == TermValue::Undefined)
-            undefinedLiterals.push_back(i);
+// удаление литерала из клаузы
+void ConjunctiveNormalForm::StrengthenClause(size_t clause, int literal) {
+    int *clauseLiterals = GetClauseLiterals(clause);
+    int size = clauses[clause].size;
 
-    return undefinedLiterals[rand() % undefinedLiterals.size()];
+    std::remove(clauseLiterals, clauseLiterals + size, literal); // порядок остальных литералов сохраняется
+    clauses[clause].size--;
 }
 
-// литерал с наибольшим числом вхождений
-int ConjunctiveNormalForm::GetMaxOccurencesLiteral() const {
-    std::unordered_map<int, int> counts;
+// удаление поглощённых клауз и самопоглощающая резолюция
+void ConjunctiveNormalForm::Subsumption() {
+    auto start = std::chrono::steady_clock::now();
 
-    for (int i = 1; i <= literalsCount; i++)
-        counts[i] = 0;
+    std::vector<bool> removed(clauses.size(), false);
+    std::vector<uint64_t> signatures(clauses.size());
+    std::vector<std::vector<int>> occurrences(2 * literalsCount + 2);
+    std::vector<int> queue;
+    std::vector<bool> queued(clauses.size(), false);
 
     for (size_t i = 0; i < clauses.size(); i++) {
-        if (IsRemovedClause(i))
-            continue;
+        int size = clauses[i].size;
+        clauses[i].size = NormalizeClause(GetClauseLiterals(i), size);
+
+        if (clauses[i].size < 0) {
+            if (proof != nullptr)
+                proof->DeleteClause(GetClauseLiterals(i), size);
 
-        for (auto j = clauses[i].begin(); j != clauses[i].end(); j++) {
-            counts[abs(*j)]++;
+            removed[i] = true;
+            preprocessing.tautologies++;
+            continue;
         }
-    }
 
-    int literal = 0;
+        const int *clauseLiterals = GetClauseLiterals(i);
 
-    for (auto it = counts.begin(); it != counts.end(); it++) {
-        if (values[abs(it->first)] != TermValue::Undefined)
-            continue;
+        for (int j = 0; j < clauses[i].size; j++)
+            occurrences[clauseLiterals[j]].push_back(i);
 
-        if (literal == 0 || it->second > counts[literal])
-            literal = it->first;
+        signatures[i] = GetClauseSignature(i);
+        queue.push_back(i);
+        queued[i] = true;
     }
 
-    return literal;
-}
-
-// литерал с наибольшим числом вхождений в кратчайшие клаузы
-int ConjunctiveNormalForm::GetMomsOccurencesLiteral() const {
-    int minLength = literalsCount;
+    // короткие клаузы поглощают чаще, поэтому проверяем их первыми
+    std::stable_sort(queue.begin(), queue.end(), [this](int a, int b) { return clauses[a].size < clauses[b].size; });
 
-    for (size_t i = 0; i < clauses.size(); i++) {
-        int size = GetClauseSize(i);
+    std::vector<int> candidates;
 
-        if (!IsRemovedClause(i) && size < minLength)
-            minLength = size;
-    }
+    for (size_t q = 0; q < queue.size(); q++) {
+        int clause = queue[q];
+        queued[clause] = false;
 
-    std::unordered_map<int, int> counts;
+        if (removed[clause])
+            continue;
 
-    for (int i = 1; i <= literalsCount; i++)
-        counts[i] = 0;
+        // кандидаты берутся из списков самой редкой переменной клаузы
+        const int *clauseLiterals = GetClauseLiterals(clause);
+        int best = -1;
 
-    for (size_t i = 0; i < clauses.size(); i++) {
-        if (IsRemovedClause(i) || GetClauseSize(i) != minLength)
-            continue;
+        for (int i = 0; i < clauses[clause].size; i++) {
+            int literal = clauseLiterals[i];
 
-        for (auto j = clauses[i].begin(); j != clauses[i].end(); j++) {
-            counts[abs(*j)]++;
+            if (best < 0 || occurrences[literal].size() + occurrences[literal ^ 1].size() < occurrences[best].size() + occurrences[best ^ 1].size())
+                best = literal;
         }
-    }
 
-    int literal = 0;
+        if (best < 0)
+            continue; // пустая клауза
 
-    for (auto it = counts.begin(); it != counts.end(); it++) {
-        if (values[abs(it->first)] != TermValue::Undefined)
-            continue;
+        candidates = occurrences[best];
+        candidates.insert(candidates.end(), occurrences[best ^ 1].begin(), occurrences[best ^ 1].end());
 
-        if (literal == 0 || it->second > counts[literal])
-            literal = it->first;
-    }
+        for (auto it = candidates.begin(); it != candidates.end(); it++) {
+            int other = *it;
 
-    return literal;
-}
+            if (other == clause || removed[other] || clauses[other].size < clauses[clause].size || (signatures[clause] & ~signatures[other]) != 0)
+                continue;
 
-// литерал по взвешенной сумме
-int ConjunctiveNormalForm::GetWeightedLiteral() const {
-    std::unordered_map<int, double> weights;
+            int result = CheckSubsumption(clause, other);
 
-    for (int i = 1; i <= literalsCount; i++)
-        weights[i] = 0;
+            if (result == -1) { // клауза поглощена
+                if (proof != nullptr)
+                    proof->DeleteClause(GetClauseLiterals(other), clauses[other].size);
 
+                removed[other] = true;
+                preprocessing.subsumed++;
+            }
+            else if (result >= 0) { // самопоглощающая резолюция: удаляем литерал из другой клаузы
+                if (proof != nullptr) { // усиленная клауза - резольвента, затем удаляется исходная
+                    proofClause.assign(GetClauseLiterals(other), GetClauseLiterals(other) + clauses[other].size);
+                    proofClause.erase(std::find(proofClause.begin(), proofClause.end(), result));
+                    proof->AddClause(proofClause);
+                    proof->DeleteClause(GetClauseLiterals(other), clauses[other].size);
+                }
+
+                StrengthenClause(other, result);
+                std::vector<int> &occurrence = occurrences[result];
+                occurrence.erase(std::find(occurrence.begin(), occurrence.end(), other));
+                signatures[other] = GetClauseSignature(other);
+                preprocessing.strengthened++;
+
+                if (!queued[other]) { // усиленная клауза может поглотить другие
+                    queued[other] = true;
+                    queue.push_back(other);
+                }
+            }
+        }
+    }
+
+    RemoveClauses(removed);
+    clausesCount = clauses.size();
+    preprocessing.subsumptionTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// добавление пустой клаузы при доказанной при предобработке невыполнимости
+void ConjunctiveNormalForm::AddEmptyClause() {
+    if (proof != nullptr)
+        proof->AddClause(nullptr, 0);
+
+    AppendClause(std::vector<int>()); // поиск увидит её в AssignUnitClauses
+}
+
+// компоненты сильной связности графа импликаций бинарных клауз (алгоритм Тарьяна без рекурсии), false, если x и NOT x эквивалентны
+bool ConjunctiveNormalForm::FindEquivalentLiterals(std::vector<int> &representatives) const {
+    int size = 2 * literalsCount + 2;
+    std::vector<std::vector<int>> graph(size);
+
+    // клауза (a OR b) даёт импликации NOT a -> b и NOT b -> a
+    for (size_t i = 0; i < clauses.size(); i++) {
+        if (clauses[i].size != 2)
+            continue;
+
+        const int *clauseLiterals = GetClauseLiterals(i);
+        graph[clauseLiterals[0] ^ 1].push_back(clauseLiterals[1]);
+        graph[clauseLiterals[1] ^ 1].push_back(clauseLiterals[0]);
+    }
+
+    std::vector<int> indices(size, -1); // порядок входа в вершины
+    std::vector<int> lowlinks(size, 0); // наименьший порядок, достижимый из поддерева
+    std::vector<bool> onStack(size, false);
+    std::vector<int> stack; // вершины незавершённых компонент
+    std::vector<std::pair<int, size_t>> calls; // стек обхода в глубину: вершина и номер следующей дуги
+    int index = 0;
+
+    representatives.resize(size);
+
+    for (int i = 0; i < size; i++)
+        representatives[i] = i;
+
+    for (int root = 2; root < size; root++) {
+        if (indices[root] >= 0 || graph[root].empty())
+            continue;
+
+        indices[root] = lowlinks[root] = index++;
+        stack.push_back(root);
+        onStack[root] = true;
+        calls.push_back({ root, 0 });
+
+        while (!calls.empty()) {
+            int vertex = calls.back().first;
+
+            if (calls.back().second < graph[vertex].size()) {
+                int next = graph[vertex][calls.back().second++];
+
+                if (indices[next] < 0) {
+                    indices[next] = lowlinks[next] = index++;
+                    stack.push_back(next);
+                    onStack[next] = true;
+                    calls.push_back({ next, 0 });
+                }
+                else if (onStack[next]) {
+                    lowlinks[vertex] = std::min(lowlinks[vertex], indices[next]);
+                }
+
+                continue;
+            }
+
+            calls.pop_back();
+
+            if (!calls.empty())
+                lowlinks[calls.back().first] = std::min(lowlinks[calls.back().first], lowlinks[vertex]);
+
+            if (lowlinks[vertex] != indices[vertex])
+                continue;
+
+            // vertex - корень компоненты, представитель - литерал с наименьшим кодом (у отрицаний компоненты - его отрицание)
+            size_t begin = stack.size() - 1;
+
+            while (stack[begin] != vertex)
+                begin--;
+
+            int representative = *std::min_element(stack.begin() + begin, stack.end());
+
+            for (size_t i = begin; i < stack.size(); i++) {
+                onStack[stack[i]] = false;
+                representatives[stack[i]] = representative;
+            }
+
+            stack.resize(begin);
+        }
+    }
+
+    for (int i = 1; i <= literalsCount; i++)
+        if (representatives[2 * i] == representatives[2 * i + 1])
+            return false;
+
+    return true;
+}
+
+// замена литералов представителями классов эквивалентности, возвращает число заменённых переменных
+int ConjunctiveNormalForm::SubstituteEquivalentLiterals(const std::vector<int> &representatives, std::vector<bool> &removed) {
+    std::vector<int> changed; // номера изменённых клауз
+    std::vector<std::vector<int>> substituted; // их новые литералы (пустой вектор для тавтологии)
+
+    for (size_t i = 0; i < clauses.size(); i++) {
+        const int *clauseLiterals = GetClauseLiterals(i);
+        int size = clauses[i].size;
+        bool isChanged = false;
+
+        for (int j = 0; j < size && !isChanged; j++)
+            isChanged = representatives[clauseLiterals[j]] != clauseLiterals[j];
+
+        if (!isChanged)
+            continue;
+
+        std::vector<int> clause(size);
+
+        for (int j = 0; j < size; j++)
+            clause[j] = representatives[clauseLiterals[j]];
+
+        int newSize = NormalizeClause(clause.data(), size);
+        clause.resize(std::max(newSize, 0));
+
+        // замена выводится по цепочке бинарных клауз, поэтому все новые клаузы записываются до удаления старых
+        if (newSize >= 0 && proof != nullptr)
+            proof->AddClause(clause);
+
+        changed.push_back(i);
+        substituted.push_back(clause);
+    }
+
+    for (size_t k = 0; k < changed.size(); k++) {
+        int clause = changed[k];
+
+        if (proof != nullptr)
+            proof->DeleteClause(GetClauseLiterals(clause), clauses[clause].size);
+
+        if (substituted[k].empty()) { // тавтология, в том числе бинарные клаузы самой эквивалентности
+            removed[clause] = true;
+            preprocessing.tautologies++;
+            continue;
+        }
+
+        std::copy(substituted[k].begin(), substituted[k].end(), GetClauseLiterals(clause)); // клауза не длиннее исходной
+        clauses[clause].size = substituted[k].size();
+    }
+
+    int count = 0;
+
+    // x = r восстанавливается клаузами (x OR NOT r) и (NOT x OR r): при разборе с конца x сначала ложна, затем становится истинной, если истинна r
+    for (int i = 1; i <= literalsCount; i++) {
+        int representative = representatives[2 * i];
+
+        if (representative == 2 * i)
+            continue;
+
+        eliminationStack.insert(eliminationStack.end(), { 2 * i, representative ^ 1, 2, 2 * i + 1, representative, 2 });
+        eliminated[i] = true;
+        count++;
+    }
+
+    return count;
+}
+
+// пробы литералов на нулевом уровне: отрицание опровергнутого литерала присваивается и распространяется (false при противоречии)
+bool ConjunctiveNormalForm::ProbeFailedLiterals(const std::chrono::steady_clock::time_point &deadline) {
+    std::stack<int> assignments;
+    std::stack<int> probed;
+
+    FillWatchLists();
+
+    if (!AssignUnitClauses(assignments) || !UnitPropagation(assignments))
+        return false;
+
+    for (int i = 1; i <= literalsCount && std::chrono::steady_clock::now() < deadline; i++) {
+        for (int sign = 0; sign < 2; sign++) {
+            int literal = 2 * i + sign;
+
+            if (values[i] != TermValue::Undefined || l2c[literal ^ 1].empty())
+                continue; // литерал ничего не сокращает - и опровергнуть его нечем
+
+            AssignLiteral(literal, -1);
+            probed.push(literal);
+
+            bool conflict = !UnitPropagation(probed);
+
+            for (; !probed.empty(); probed.pop())
+                SetValue(probed.top() >> 1, TermValue::Undefined);
+
+            if (!conflict)
+                continue;
+
+            preprocessing.failedLiterals++;
+
+            if (proof != nullptr)
+                proof->AddClause(std::vector<int>(1, literal ^ 1));
+
+            AssignLiteral(literal ^ 1, -1);
+            assignments.push(literal ^ 1);
+
+            if (!UnitPropagation(assignments))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// удаление выполненных клауз и ложных литералов по присваиваниям нулевого уровня, возвращает число зафиксированных переменных
+int ConjunctiveNormalForm::SimplifyByRootAssignments(std::vector<bool> &removed) {
+    std::vector<bool> hasUnit(literalsCount + 1, false);
+    int count = 0;
+
+    for (size_t i = 0; i < clauses.size(); i++)
+        if (clauses[i].size == 1)
+            hasUnit[GetClauseLiterals(i)[0] >> 1] = true;
+
+    // значения нулевого уровня сохраняются единичными клаузами, записываются до удаления клауз, из которых выведены
+    for (int i = 1; i <= literalsCount; i++) {
+        if (values[i] == TermValue::Undefined || eliminated[i] || hasUnit[i])
+            continue;
+
+        std::vector<int> unit(1, 2 * i + (values[i] == TermValue::False));
+
+        if (proof != nullptr)
+            proof->AddClause(unit);
+
+        AppendClause(unit);
+        removed.push_back(false);
+        count++;
+    }
+
+    for (size_t i = 0; i < clauses.size(); i++) {
+        int *clauseLiterals = GetClauseLiterals(i);
+        int size = clauses[i].size;
+
+        if (removed[i] || size == 1)
+            continue;
+
+        bool satisfied = false;
+        proofClause.clear();
+
+        for (int j = 0; j < size && !satisfied; j++) {
+            TermValue value = GetLiteralValue(clauseLiterals[j]);
+            satisfied = value == TermValue::True;
+
+            if (value == TermValue::Undefined)
+                proofClause.push_back(clauseLiterals[j]);
+        }
+
+        if (satisfied) {
+            if (proof != nullptr)
+                proof->DeleteClause(clauseLiterals, size);
+
+            removed[i] = true;
+            continue;
+        }
+
+        if (proofClause.size() == size)
+            continue; // ложных литералов нет
+
+        if (proof != nullptr) {
+            proof->AddClause(proofClause);
+            proof->DeleteClause(clauseLiterals, size);
+        }
+
+        std::copy(proofClause.begin(), proofClause.end(), clauseLiterals);
+        clauses[i].size = proofClause.size();
+    }
+
+    for (int i = 1; i <= literalsCount; i++)
+        SetValue(i, TermValue::Undefined);
+
+    propagationQueue = std::queue<int>();
+    return count;
+}
+
+// пробы литералов и замена эквивалентных литералов до неподвижной точки или исчерпания бюджета времени
+void ConjunctiveNormalForm::Probing() {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(probingBudget));
+    std::vector<int> representatives;
+    bool changed = true;
+
+    // эквивалентности ищутся по отсортированным клаузам без повторов
+    std::vector<bool> removed(clauses.size(), false);
+
+    for (size_t i = 0; i < clauses.size(); i++) {
+        int size = clauses[i].size;
+        clauses[i].size = NormalizeClause(GetClauseLiterals(i), size);
+
+        if (clauses[i].size < 0) {
+            if (proof != nullptr)
+                proof->DeleteClause(GetClauseLiterals(i), size);
+
+            removed[i] = true;
+            preprocessing.tautologies++;
+        }
+    }
+
+    RemoveClauses(removed);
+
+    while (changed && std::chrono::steady_clock::now() < deadline) {
+        changed = false;
+        removed.assign(clauses.size(), false);
+
+        if (!FindEquivalentLiterals(representatives)) { // x эквивалентна NOT x
+            int variable = 1;
+
+            while (representatives[2 * variable] != representatives[2 * variable + 1])
+                variable++;
+
+            if (proof != nullptr) // x -> NOT x по бинарным клаузам даёт NOT x, затем NOT x -> x даёт пустую клаузу
+                proof->AddClause(std::vector<int>(1, 2 * variable + 1));
+
+            AddEmptyClause();
+            break;
+        }
+
+        int equivalent = SubstituteEquivalentLiterals(representatives, removed);
+        preprocessing.equivalentVariables += equivalent;
+        RemoveClauses(removed);
+
+        if (!ProbeFailedLiterals(deadline)) {
+            AddEmptyClause();
+            break;
+        }
+
+        removed.assign(clauses.size(), false);
+        int fixed = SimplifyByRootAssignments(removed);
+        preprocessing.fixedVariables += fixed;
+        RemoveClauses(removed);
+
+        // новые бинарные клаузы могут дать новые эквивалентности
+        changed = equivalent > 0 || fixed > 0;
+    }
+
+    for (int i = 1; i <= literalsCount; i++)
+        SetValue(i, TermValue::Undefined);
+
+    propagationQueue = std::queue<int>();
+    clausesCount = clauses.size();
+    preprocessing.probingTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// резольвента двух клауз по переменной (false для тавтологии)
+bool ConjunctiveNormalForm::Resolve(size_t clause1, size_t clause2, int variable, std::vector<int> &resolvent) const {
+    const int *literals1 = GetClauseLiterals(clause1);
+    const int *literals2 = GetClauseLiterals(clause2);
+
+    resolvent.clear();
+
+    for (int i = 0; i < clauses[clause1].size; i++)
+        if ((literals1[i] >> 1) != variable)
+            resolvent.push_back(literals1[i]);
+
+    for (int i = 0; i < clauses[clause2].size; i++)
+        if ((literals2[i] >> 1) != variable)
+            resolvent.push_back(literals2[i]);
+
+    int size = NormalizeClause(resolvent.data(), resolvent.size());
+
+    if (size < 0)
+        return false;
+
+    resolvent.resize(size);
+    return true;
+}
+
+// исключение переменной резолюцией, если число клауз не растёт
+bool ConjunctiveNormalForm::EliminateVariable(int variable, std::vector<bool> &removed, std::vector<std::vector<int>> &resolvents) {
+    std::vector<int> positive;
+    std::vector<int> negative;
+
+    // в списках l2c остаются удалённые клаузы, пропускаем их
+    for (auto it = l2c[2 * variable].begin(); it != l2c[2 * variable].end(); it++)
+        if (!removed[*it])
+            positive.push_back(*it);
+
+    for (auto it = l2c[2 * variable + 1].begin(); it != l2c[2 * variable + 1].end(); it++)
+        if (!removed[*it])
+            negative.push_back(*it);
+
+    if (positive.empty() && negative.empty())
+        return false; // переменная не входит в формулу
+
+    size_t limit = positive.size() + negative.size();
+    size_t count = 0;
+
+    for (size_t i = 0; i < positive.size(); i++) {
+        for (size_t j = 0; j < negative.size(); j++) {
+            if (count == resolvents.size())
+                resolvents.emplace_back();
+
+            if (!Resolve(positive[i], negative[j], variable, resolvents[count]))
+                continue;
+
+            if (++count > limit)
+                return false; // число клауз выросло бы
+        }
+    }
+
+    if (proof != nullptr) // резольвенты выводятся до удаления клауз переменной
+        for (size_t i = 0; i < count; i++)
+            proof->AddClause(resolvents[i]);
+
+    // сохраняем клаузы переменной для восстановления модели
+    for (int sign = 0; sign < 2; sign++) {
+        std::vector<int> &occurrence = sign == 0 ? positive : negative;
+
+        for (auto it = occurrence.begin(); it != occurrence.end(); it++) {
+            const int *clauseLiterals = GetClauseLiterals(*it);
+            eliminationStack.push_back(2 * variable + sign);
+
+            for (int k = 0; k < clauses[*it].size; k++)
+                if (clauseLiterals[k] != 2 * variable + sign)
+                    eliminationStack.push_back(clauseLiterals[k]);
+
+            eliminationStack.push_back(clauses[*it].size);
+            removed[*it] = true;
+
+            if (proof != nullptr)
+                proof->DeleteClause(clauseLiterals, clauses[*it].size);
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        for (auto it = resolvents[i].begin(); it != resolvents[i].end(); it++)
+            l2c[*it].push_back(clauses.size());
+
+        AppendClause(resolvents[i]);
+        removed.push_back(false);
+    }
+
+    eliminated[variable] = true;
+    return true;
+}
+
+// ограниченное исключение переменных (SatELite)
+void ConjunctiveNormalForm::VariableElimination() {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<bool> removed(clauses.size(), false);
+    int clausesBefore = clauses.size();
+
+    // резольвенты строятся из отсортированных клауз без повторов
+    for (size_t i = 0; i < clauses.size(); i++) {
+        int size = clauses[i].size;
+        clauses[i].size = NormalizeClause(GetClauseLiterals(i), size);
+
+        if (clauses[i].size < 0) {
+            if (proof != nullptr)
+                proof->DeleteClause(GetClauseLiterals(i), size);
+
+            removed[i] = true;
+            clausesBefore--;
+            preprocessing.tautologies++;
+        }
+    }
+
+    FillOccurrenceLists();
+
+    // сначала пробуем переменные с наименьшим числом резольвент
+    std::vector<int> order;
+    std::vector<size_t> costs(literalsCount + 1);
+
+    for (int i = 1; i <= literalsCount; i++) {
+        costs[i] = l2c[2 * i].size() * l2c[2 * i + 1].size();
+        order.push_back(i);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&costs](int a, int b) { return costs[a] < costs[b]; });
+
+    std::vector<std::vector<int>> resolvents;
+
+    for (auto it = order.begin(); it != order.end(); it++)
+        if (EliminateVariable(*it, removed, resolvents))
+            preprocessing.eliminatedVariables++;
+
+    RemoveClauses(removed);
+    clausesCount = clauses.size();
+    preprocessing.eliminatedClauses = clausesBefore - clausesCount;
+    preprocessing.eliminationTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// перенос модели другого решателя с восстановлением исключённых переменных
+void ConjunctiveNormalForm::SetExternalModel(const std::function<bool(int)> &getValue) {
+    // исключённые переменные не входят в клаузы, их значения восстановит ExtendModel
+    for (int i = 1; i <= literalsCount; i++)
+        SetValue(i, !eliminated[i] && getValue(i) ? TermValue::True : TermValue::False);
+
+    ExtendModel();
+}
+
+// восстановление значений исключённых переменных (в обратном порядке исключения)
+void ConjunctiveNormalForm::ExtendModel() {
+    int index = eliminationStack.size();
+
+    while (index > 0) {
+        int size = eliminationStack[index - 1];
+        index -= size + 1;
+
+        int literal = eliminationStack[index]; // исключаемый литерал
+        bool satisfied = GetLiteralValue(literal) == TermValue::True;
+
+        for (int i = 1; i < size && !satisfied; i++)
+            satisfied = GetLiteralValue(eliminationStack[index + i]) == TermValue::True;
+
+        if (!satisfied) // клауза выполняется только исключаемым литералом
+            SetValue(literal >> 1, (literal & 1) ? TermValue::False : TermValue::True);
+    }
+}
+
+// вывод СКНФ
+void ConjunctiveNormalForm::Print() const {
+    std::cout << "Literals count: " << literalsCount << std::endl;
+    std::cout << "Clauses count: " << clausesCount << std::endl;
+    std::cout << "Clauses:" << std::endl;
+
+    bool wasPrinted = false;
+
+    for (int i = 0; i < clausesCount; i++) {
+        if (wasPrinted)
+            std::cout << "  AND" << std::endl;
+
+        std::cout << "  (";
+
+        const int *clause = GetClauseLiterals(i);
+
+        for (int j = 0; j < clauses[i].size; j++) {
+            if (j > 0) {
+                std::cout << " OR ";
+            }
+
+            int literal = DecodeLiteral(clause[j]);
+
+            if (literal < 0) {
+                std::cout << "NOT x" << (-literal);
+            }
+            else {
+                std::cout << "x" << literal;
+            }
+        }
+
+        std::cout << ")" << std::endl;
+        wasPrinted = true;
+    }
+}
+
+// статистика предобработки
+const PreprocessingStatistics& ConjunctiveNormalForm::GetPreprocessingStatistics() const {
+    return preprocessing;
+}
+
+// статистика поиска
+const SolverStatistics& ConjunctiveNormalForm::GetSolverStatistics() const {
+    return statistics;
+}
+
+// счётчики и таймеры горячих участков
+const InstrumentationStatistics& ConjunctiveNormalForm::GetInstrumentationStatistics() const {
+    return instrumentation;
+}
+
+// установка политики перезапусков
+void ConjunctiveNormalForm::SetRestartPolicy(RestartPolicy policy) {
+    restartPolicy = policy;
+}
+
+// включение сохранения фаз
+void ConjunctiveNormalForm::SetPhaseSaving(bool phaseSaving) {
+    this->phaseSaving = phaseSaving;
+}
+
+// решать ли DPLL формул до 256 переменных битовым движком
+void ConjunctiveNormalForm::SetBitParallel(bool bitParallel) {
+    this->bitParallel = bitParallel;
+}
+
+// установка зерна генератора случайных чисел
+void ConjunctiveNormalForm::SetSeed(unsigned seed) {
+    generator.seed(seed);
+}
+
+// печать строки прогресса каждые conflicts конфликтов (0 - выключено)
+void ConjunctiveNormalForm::SetProgressInterval(long long conflicts) {
+    progressInterval = conflicts;
+}
+
+// запись доказательства следующих вызовов поиска (nullptr - без доказательства)
+void ConjunctiveNormalForm::SetProofWriter(ProofWriter *proof) {
+    this->proof = proof;
+}
+
+// установка ограничений для следующих вызовов поиска
+void ConjunctiveNormalForm::SetLimits(const SearchLimits &limits) {
+    if (limits.time < 0 || limits.conflicts < 0 || limits.decisions < 0)
+        throw std::string("ConjunctiveNormalForm::SetLimits: limits must be non-negative");
+
+    this->limits = limits;
+}
+
+// ограничения поиска
+const SearchLimits& ConjunctiveNormalForm::GetLimits() const {
+    return limits;
+}
+
+// установка флага для кооперативной остановки поиска
+void ConjunctiveNormalForm::SetInterruptFlag(const std::atomic<bool> *flag) {
+    interruptFlag = flag;
+}
+
+// установка запроса и получателя частей дерева поиска DPLL
+void ConjunctiveNormalForm::SetSplitHandler(const std::atomic<bool> *flag, std::function<void(const std::vector<int>&)> handler) {
+    splitFlag = flag;
+    splitHandler = handler;
+}
+
+// число переменных
+int ConjunctiveNormalForm::GetVariablesCount() const {
+    return literalsCount;
+}
+
+// число вхождений переменной в исходные клаузы
+int ConjunctiveNormalForm::GetOccurrencesCount(int variable) const {
+    return l2c[2 * variable].size() + l2c[2 * variable + 1].size();
+}
+
+// был ли последний поиск остановлен без ответа
+bool ConjunctiveNormalForm::WasInterrupted() const {
+    return stopReason != StopReason::None;
+}
+
+// почему последний поиск остановлен без ответа
+StopReason ConjunctiveNormalForm::GetStopReason() const {
+    return stopReason;
+}
+
+// решён ли последний поиск битовым движком
+bool ConjunctiveNormalForm::WasBitParallel() const {
+    return bitParallelUsed;
+}
+
+// вывод значений термов
+void ConjunctiveNormalForm::PrintTermValues() const {
+    std::cout << "+------------+-----------+" << std::endl;
+    std::cout << "|    term    |   value   |" << std::endl;
+    std::cout << "+------------+-----------+" << std::endl;
+
+    for (size_t i = 1; i < values.size(); i++) {
+        std::cout << "| " << std::setw(10) << ("x" + std::to_string(i)) << " | " << std::setw(9);
+
+        switch (values[i]) {
+            case TermValue::Undefined:
+                std::cout << "undefined";
+                break;
+
+            case TermValue::True:
+                std::cout << "true";
+                break;
+
+            case TermValue::False:
+                std::cout << "false";
+                break;
+        }
+
+        std::cout << " |" << std::endl;
+    }
+
+    std::cout << "+------------+-----------+" << std::endl;
+}
+
+// литералы клаузы
+int* ConjunctiveNormalForm::GetClauseLiterals(size_t index) {
+    return literals.data() + clauses[index].offset;
+}
+
+// литералы клаузы
+const int* ConjunctiveNormalForm::GetClauseLiterals(size_t index) const {
+    return literals.data() + clauses[index].offset;
+}
+
+// получение значения литерала
+TermValue ConjunctiveNormalForm::GetLiteralValue(int literal) const {
+    return literalValues[literal];
+}
+
+// список клауз, наблюдающих литерал
+std::vector<int>& ConjunctiveNormalForm::GetWatchList(int literal) {
+    return watches[literal];
+}
+
+// подключение клаузы к распространению: бинарной - к спискам импликаций, длинной - к спискам наблюдения
+void ConjunctiveNormalForm::WatchClause(int clause) {
+    const int *clauseLiterals = GetClauseLiterals(clause);
+
+    if (clauses[clause].size == 2) {
+        implications[clauseLiterals[0]].push_back({ clauseLiterals[1], clause });
+        implications[clauseLiterals[1]].push_back({ clauseLiterals[0], clause });
+    }
+    else if (clauses[clause].size > 2) { // наблюдаем первые два литерала
+        GetWatchList(clauseLiterals[0]).push_back(clause);
+        GetWatchList(clauseLiterals[1]).push_back(clause);
+    }
+}
+
+// построение счётчиков вхождений
+void ConjunctiveNormalForm::InitCounters() {
+    useCounters = true;
+    maxClauseSize = 0;
+    variableClauses = std::vector<std::vector<int>>(literalsCount + 1);
+    occurrences = std::vector<int>(literalsCount + 1, 0);
+    weights = std::vector<double>(literalsCount + 1, 0);
+    sizeOccurrences.clear();
+    sizeClauses.clear();
+    sizeWeights.clear();
+    clauseSizes.clear();
+    clauseTrueCounts.clear();
+    countedValues = values;
+    changedVariables.clear();
+    isChangedVariable = std::vector<bool>(literalsCount + 1, false);
+    touchedClauses.clear();
+    isTouchedClause.clear();
+
+    for (size_t i = 0; i < clauses.size(); i++)
+        AddClauseToCounters(i);
+}
+
+// расширение счётчиков под клаузы большего размера
+void ConjunctiveNormalForm::ResizeCounters(int clauseSize) {
+    if (clauseSize <= maxClauseSize && !sizeClauses.empty())
+        return;
+
+    maxClauseSize = std::max(maxClauseSize, clauseSize);
+    sizeOccurrences.resize((maxClauseSize + 1) * (literalsCount + 1), 0);
+    sizeClauses.resize(maxClauseSize + 1, 0);
+
+    for (int size = sizeWeights.size(); size <= maxClauseSize; size++)
+        sizeWeights.push_back(std::ldexp(1.0, -size));
+}
+
+// добавление клаузы в счётчики вхождений
+void ConjunctiveNormalForm::AddClauseToCounters(size_t clause) {
+    ResizeCounters(clauses[clause].size);
+
+    const int *clauseLiterals = GetClauseLiterals(clause);
+
+    for (int i = 0; i < clauses[clause].size; i++) {
+        std::vector<int> &variableClause = variableClauses[clauseLiterals[i] >> 1];
+
+        if (variableClause.empty() || variableClause.back() != clause) // повторяющиеся литералы учитываем один раз
+            variableClause.push_back(clause);
+    }
+
+    clauseSizes.push_back(0);
+    clauseTrueCounts.push_back(0);
+    isTouchedClause.push_back(false);
+    RecountClause(clause);
+    UpdateClauseCounters(clause, 1);
+}
+
+// пересчёт размера клаузы и числа истинных литералов
+void ConjunctiveNormalForm::RecountClause(size_t clause) {
+    int size = 0;
+    int trueCount = 0;
+    const int *clauseLiterals = GetClauseLiterals(clause);
+
+    for (int i = 0; i < clauses[clause].size; i++) {
+        TermValue value = countedValues[clauseLiterals[i] >> 1];
+
+        if (value == TermValue::Undefined) {
+            size++;
+        }
+        else if ((value == TermValue::True) == !(clauseLiterals[i] & 1)) {
+            trueCount++;
+        }
+    }
+
+    clauseSizes[clause] = size;
+    clauseTrueCounts[clause] = trueCount;
+}
+
+// учёт (+1) или снятие (-1) вклада клаузы в счётчики
+void ConjunctiveNormalForm::UpdateClauseCounters(size_t clause, int sign) {
+    if (clauseTrueCounts[clause] > 0)
+        return; // выполненные клаузы не учитываются
+
+    int size = clauseSizes[clause];
+    double weight = sign * sizeWeights[size];
+    int *counts = sizeOccurrences.data() + size * (literalsCount + 1);
+
+    sizeClauses[size] += sign;
+
+    const int *clauseLiterals = GetClauseLiterals(clause);
+
+    for (int i = 0; i < clauses[clause].size; i++) {
+        int variable = clauseLiterals[i] >> 1;
+
+        if (countedValues[variable] != TermValue::Undefined)
+            continue;
+
+        occurrences[variable] += sign;
+        counts[variable] += sign;
+        weights[variable] += weight;
+    }
+}
+
+// обновление счётчиков по переменным, изменённым с последней синхронизации
+void ConjunctiveNormalForm::SyncCounters() {
+    // снимаем вклад затронутых клауз по старым значениям
+    for (auto it = changedVariables.begin(); it != changedVariables.end(); it++) {
+        if (countedValues[*it] == values[*it])
+            continue; // присваивание было отменено откатом
+
+        for (auto clause = variableClauses[*it].begin(); clause != variableClauses[*it].end(); clause++) {
+            if (isTouchedClause[*clause])
+                continue;
+
+            isTouchedClause[*clause] = true;
+            touchedClauses.push_back(*clause);
+            UpdateClauseCounters(*clause, -1);
+        }
+    }
+
+    for (auto it = changedVariables.begin(); it != changedVariables.end(); it++) {
+        isChangedVariable[*it] = false;
+        countedValues[*it] = values[*it];
+    }
+
+    // и учитываем его заново по новым
+    for (auto clause = touchedClauses.begin(); clause != touchedClauses.end(); clause++) {
+        isTouchedClause[*clause] = false;
+        RecountClause(*clause);
+        UpdateClauseCounters(*clause, 1);
+    }
+
+    changedVariables.clear();
+    touchedClauses.clear();
+}
+
+// изменение значения переменной с отметкой для счётчиков
+void ConjunctiveNormalForm::SetValue(int variable, TermValue value) {
+    values[variable] = value;
+    literalValues[2 * variable] = value;
+    literalValues[2 * variable + 1] = value == TermValue::Undefined ? value : (value == TermValue::True ? TermValue::False : TermValue::True);
+
+    if (useCounters && !isChangedVariable[variable]) {
+        isChangedVariable[variable] = true;
+        changedVariables.push_back(variable);
+    }
+}
+
+// присваивание литералу истинного значения
+void ConjunctiveNormalForm::AssignLiteral(int literal, int reason) {
+    int variable = literal >> 1;
+
+    SetValue(variable, literal & 1 ? TermValue::False : TermValue::True);
+    levels[variable] = level;
+    reasons[variable] = reason;
+    propagationQueue.push(literal); // литерал ещё предстоит распространить
+}
+
+// сброс значения литерала
+void ConjunctiveNormalForm::UnassignLiteral(int literal) {
+    if (phaseSaving)
+        savedPhases[literal >> 1] = literal & 1 ? TermValue::False : TermValue::True;
+
+    SetValue(literal >> 1, TermValue::Undefined);
+    vsids.Insert(literal >> 1); // возвращаем переменную в кучу, если её оттуда извлекли
+}
+
+// распространение константы
+void ConjunctiveNormalForm::PropagateLiteral(int literal, int reason, std::stack<int> &assignments) {
+    up[literal >> 1]++;
+    statistics.propagations++;
+
+    AssignLiteral(literal, reason);
+    assignments.push(literal);
+}
+
+// присваивание литералов исходных единичных клауз
+bool ConjunctiveNormalForm::AssignUnitClauses(std::stack<int> &assignments) {
     for (size_t i = 0; i < clauses.size(); i++) {
-        if (IsRemovedClause(i))
+        if (clauses[i].size > 1)
+            continue;
+
+        if (clauses[i].size == 0)
+            return false; // пустая клауза невыполнима
+
+        int literal = GetClauseLiterals(i)[0];
+        TermValue value = GetLiteralValue(literal);
+
+        if (value == TermValue::False)
+            return false; // противоречивые единичные клаузы
+
+        if (value == TermValue::Undefined)
+            PropagateLiteral(literal, i, assignments);
+    }
+
+    // исключённые переменные не входят в клаузы, фиксируем их на нулевом уровне, значения восстановит ExtendModel
+    for (int i = 1; i <= literalsCount; i++) {
+        if (eliminated[i] && values[i] == TermValue::Undefined) {
+            AssignLiteral(2 * i + 1, -1);
+            assignments.push(2 * i + 1);
+        }
+    }
+
+    return true;
+}
+
+// распространение констант до неподвижной точки (false при конфликте)
+bool ConjunctiveNormalForm::UnitPropagation(std::stack<int> &assignments) {
+    INSTRUMENT_SCOPE(instrumentation, PropagationPhase);
+
+    while (!propagationQueue.empty()) {
+        int falseLiteral = propagationQueue.front() ^ 1; // литерал, ставший ложным
+        propagationQueue.pop();
+
+        // бинарные клаузы: второй литерал берётся прямо из списка, без обращения к клаузе
+        const std::vector<BinaryImplication> &implicationList = implications[falseLiteral];
+
+        for (auto it = implicationList.begin(); it != implicationList.end(); it++) {
+            TermValue value = GetLiteralValue(it->literal);
+
+            if (value == TermValue::True)
+                continue;
+
+            if (value == TermValue::False) { // оба литерала ложны - конфликт
+                propagationQueue = std::queue<int>();
+                conflictClause = it->clause;
+                return false;
+            }
+
+            PropagateLiteral(it->literal, it->clause, assignments);
+        }
+
+        std::vector<int> &watchList = GetWatchList(falseLiteral);
+        size_t i = 0;
+        size_t j = 0;
+
+        while (i < watchList.size()) {
+            int index = watchList[i++];
+            int *clause = GetClauseLiterals(index);
+            int size = clauses[index].size;
+            INSTRUMENT(instrumentation.clauseVisits++);
+
+            // ложный наблюдаемый литерал всегда держим на второй позиции
+            if (clause[0] == falseLiteral)
+                std::swap(clause[0], clause[1]);
+
+            if (GetLiteralValue(clause[0]) == TermValue::True) {
+                watchList[j++] = index; // клауза уже выполнена
+                continue;
+            }
+
+            bool moved = false;
+
+            // ищем новый неложный литерал для наблюдения
+            for (int k = 2; k < size && !moved; k++) {
+                if (GetLiteralValue(clause[k]) != TermValue::False) {
+                    std::swap(clause[1], clause[k]);
+                    GetWatchList(clause[1]).push_back(index);
+                    moved = true;
+                }
+            }
+
+            if (moved)
+                continue;
+
+            watchList[j++] = index;
+
+            if (GetLiteralValue(clause[0]) == TermValue::False) { // все литералы ложны - конфликт
+                while (i < watchList.size())
+                    watchList[j++] = watchList[i++];
+
+                watchList.resize(j);
+                propagationQueue = std::queue<int>();
+                conflictClause = index;
+                return false;
+            }
+
+            PropagateLiteral(clause[0], index, assignments); // клауза стала единичной
+        }
+
+        watchList.resize(j);
+    }
+
+    return true;
+}
+
+// первый неопределённый литерал
+int ConjunctiveNormalForm::GetFirstUndefinedLiteral() const {
+    for (int i = 1; i <= literalsCount; i++)
+        if (values[i] == TermValue::Undefined)
+            return i;
+
+    return 0; // нет неопределённых литералов
+}
+
+// случайный неопределённый литерал
+int ConjunctiveNormalForm::GetRandomUndefinedLiteral() {
+    std::vector<int> undefinedLiterals;
+
+    for (int i = 1; i <= literalsCount; i++)
+        if (values[i] == TermValue::Undefined)
+            undefinedLiterals.push_back(i);
+
+    return undefinedLiterals[generator() % undefinedLiterals.size()];
+}
+
+// литерал с наибольшим числом вхождений
+int ConjunctiveNormalForm::GetMaxOccurencesLiteral() const {
+    int literal = 0;
+
+    for (int i = 1; i <= literalsCount; i++) {
+        if (values[i] != TermValue::Undefined)
+            continue;
+
+        if (literal == 0 || occurrences[i] > occurrences[literal])
+            literal = i;
+    }
+
+    return literal;
+}
+
+// литерал с наибольшим числом вхождений в клаузы заданного размера
+int ConjunctiveNormalForm::GetMaxSizeOccurencesLiteral(int size) const {
+    if (size > maxClauseSize)
+        return GetFirstUndefinedLiteral(); // клауз такого размера нет
+
+    const int *counts = sizeOccurrences.data() + size * (literalsCount + 1);
+    int literal = 0;
+
+    for (int i = 1; i <= literalsCount; i++) {
+        if (values[i] != TermValue::Undefined)
+            continue;
+
+        if (literal == 0 || counts[i] > counts[literal])
+            literal = i;
+    }
+
+    return literal;
+}
+
+// литерал с наибольшим числом вхождений в кратчайшие клаузы
+int ConjunctiveNormalForm::GetMomsOccurencesLiteral() const {
+    int minLength = 1;
+
+    while (minLength < maxClauseSize && sizeClauses[minLength] == 0)
+        minLength++;
+
+    return GetMaxSizeOccurencesLiteral(minLength);
+}
+
+// литерал по взвешенной сумме
+int ConjunctiveNormalForm::GetWeightedLiteral() const {
+    int literal = 0;
+
+    for (int i = 1; i <= literalsCount; i++) {
+        if (values[i] != TermValue::Undefined)
+            continue;
+
+        if (literal == 0 || weights[i] > weights[literal])
+            literal = i;
+    }
+
+    return literal;
+}
+
+// литерал по стратегии Up
+int ConjunctiveNormalForm::GetUpLiteral() const {
+    int literal = 0;
+
+    for (int i = 1; i <= literalsCount; i++) {
+        if (values[i] != TermValue::Undefined)
             continue;
 
-        double weight = 1.0 / (1 << GetClauseSize(i));
+        if (literal == 0 || up[i] > up[literal])
+            literal = i;
+    }
+
+    return literal;
+}
+
+// литерал по стратегии AUPC
+int ConjunctiveNormalForm::GetAUPCLiteral() const {
+    return GetMaxSizeOccurencesLiteral(2);
+}
+
+// литерал с наибольшей активностью
+int ConjunctiveNormalForm::GetVsidsLiteral() {
+    while (!vsids.Empty()) {
+        int variable = vsids.Pop();
+
+        if (values[variable] == TermValue::Undefined)
+            return variable;
+    }
+
+    return 0; // нет неопределённых литералов
+}
+
+// отбор переменных-кандидатов для просмотра вперёд: неопределённые с наибольшим весом 2^-size по невыполненным клаузам
+void ConjunctiveNormalForm::SelectLookAheadCandidates() {
+    lookAheadCandidates.clear();
+
+    for (int i = 1; i <= literalsCount; i++)
+        if (values[i] == TermValue::Undefined)
+            lookAheadCandidates.push_back(i);
+
+    size_t count = std::max((size_t) lookAheadMinCandidates, (size_t) (lookAheadCandidates.size() * lookAheadFraction));
+
+    if (count >= lookAheadCandidates.size())
+        return;
+
+    std::nth_element(lookAheadCandidates.begin(), lookAheadCandidates.begin() + count, lookAheadCandidates.end(), [this](int a, int b) {
+        return weights[a] > weights[b];
+    });
+
+    lookAheadCandidates.resize(count);
+}
+
+// пробное распространение литерала: оценка сокращённых клауз (-1 при конфликте)
+double ConjunctiveNormalForm::ProbeLiteral(int literal) {
+    statistics.lookAheads++;
+
+    AssignLiteral(literal, -1);
+    lookAheadTrail.push(literal);
+
+    bool conflict = !UnitPropagation(lookAheadTrail);
+    double score = 0;
+
+    lookAheadLiterals.clear();
+
+    for (; !lookAheadTrail.empty(); lookAheadTrail.pop())
+        lookAheadLiterals.push_back(lookAheadTrail.top());
+
+    lookAheadStamp++;
+
+    // каждую невыполненную исходную клаузу с ложным литералом учитываем один раз с весом по оставшемуся размеру
+    for (size_t i = 0; i < lookAheadLiterals.size() && !conflict; i++) {
+        const std::vector<int> &reduced = l2c[lookAheadLiterals[i] ^ 1];
+
+        for (auto clause = reduced.begin(); clause != reduced.end(); clause++) {
+            if (lookAheadStamps[*clause] == lookAheadStamp)
+                continue;
+
+            lookAheadStamps[*clause] = lookAheadStamp;
+
+            const int *clauseLiterals = GetClauseLiterals(*clause);
+            double weight = 1;
+            int size = 0;
+
+            for (int j = 0; j < clauses[*clause].size && weight > 0; j++) {
+                TermValue value = GetLiteralValue(clauseLiterals[j]);
+
+                if (value == TermValue::True)
+                    weight = 0; // клауза выполнена
+                else if (value == TermValue::Undefined && ++size > 2)
+                    weight *= lookAheadDecay;
+            }
+
+            score += weight;
+        }
+    }
+
+    // снимаем пробные присваивания без сохранения фаз: это не настоящий поиск
+    for (auto it = lookAheadLiterals.begin(); it != lookAheadLiterals.end(); it++)
+        SetValue(*it >> 1, TermValue::Undefined);
+
+    return conflict ? -1 : score;
+}
+
+// литерал по просмотру вперёд (0, если присвоено отрицание опровергнутого литерала)
+int ConjunctiveNormalForm::GetLookAheadLiteral(std::stack<int> &assignments, std::stack<Assignment> &decisions) {
+    INSTRUMENT_SCOPE(instrumentation, DecisionPhase);
+    SyncCounters();
+    SelectLookAheadCandidates();
+
+    // пробные присваивания сразу отменяются, счётчикам вхождений о них знать незачем
+    useCounters = false;
+
+    int bestLiteral = 0;
+    double bestScore = -1;
+
+    for (auto it = lookAheadCandidates.begin(); it != lookAheadCandidates.end(); it++) {
+        int failed = 0;
+        double scores[2];
+
+        for (int sign = 0; sign < 2 && failed == 0; sign++) {
+            scores[sign] = ProbeLiteral(2 * *it + sign);
+
+            if (scores[sign] < 0) {
+                failed = 2 * *it + sign;
+            }
+            else if (assignments.size() + lookAheadLiterals.size() == literalsCount) { // пробное распространение нашло модель
+                bestLiteral = 2 * *it + sign;
+                bestScore = INFINITY;
+                break;
+            }
+        }
+
+        if (failed != 0) {
+            useCounters = true;
+            statistics.failedLiterals++;
+
+            if (learning)
+                return failed; // конфликт сразу после разветвления выучит клаузу с отрицанием литерала
+
+            // отрицание опровергнутого литерала следует из текущих решений и снимется откатом вместе с ними
+            if (proof != nullptr) {
+                proofClause.clear();
+
+                for (std::stack<Assignment> path = decisions; !path.empty(); path.pop())
+                    proofClause.push_back(path.top().literal ^ 1);
+
+                proofClause.push_back(failed ^ 1);
+                proof->AddClause(proofClause);
+            }
+
+            AssignLiteral(failed ^ 1, -1);
+            assignments.push(failed ^ 1);
+            return 0;
+        }
+
+        if (bestScore == INFINITY)
+            break;
+
+        double score = 1024 * scores[0] * scores[1] + scores[0] + scores[1]; // произведение оценок предпочитает сбалансированное разбиение
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestLiteral = scores[0] < scores[1] ? 2 * *it : 2 * *it + 1; // сначала ветвь, сокращающая меньше клауз
+        }
+    }
+
+    useCounters = true;
+    return bestLiteral;
+}
+
+// выбор переменной для разветвления
+int ConjunctiveNormalForm::GetDecisionVariable(DecisionStrategy strategy) {
+    if (useCounters)
+        SyncCounters();
+
+    if (strategy == DecisionStrategy::First)
+        return GetFirstUndefinedLiteral();
+
+    if (strategy == DecisionStrategy::Random)
+        return GetRandomUndefinedLiteral();
+
+    if (strategy == DecisionStrategy::Max)
+        return GetMaxOccurencesLiteral();
+
+    if (strategy == DecisionStrategy::Moms)
+        return GetMomsOccurencesLiteral();
+
+    if (strategy == DecisionStrategy::Weighted)
+        return GetWeightedLiteral();
+
+    if (strategy == DecisionStrategy::Up)
+        return GetUpLiteral();
+
+    if (strategy == DecisionStrategy::AUPC)
+        return GetAUPCLiteral();
+
+    if (strategy == DecisionStrategy::Vsids)
+        return GetVsidsLiteral();
+
+    return GetFirstUndefinedLiteral();
+}
+
+// выбор литерала для разветвления
+int ConjunctiveNormalForm::GetDecisionLiteral(DecisionStrategy strategy) {
+    INSTRUMENT_SCOPE(instrumentation, DecisionPhase);
+    int variable = GetDecisionVariable(strategy);
+
+    if (phaseSaving && savedPhases[variable] != TermValue::Undefined) { // берём последнее значение переменной
+        statistics.savedPhaseDecisions++;
+        return 2 * variable + (savedPhases[variable] == TermValue::False);
+    }
+
+    return 2 * variable; // ветвимся сначала по положительному значению
+}
+
+// увеличение активности переменной
+void ConjunctiveNormalForm::BumpVariable(int variable) {
+    vsids.Bump(variable, activityIncrement);
+
+    if (vsids.GetActivity(variable) > 1e100) { // избегаем переполнения
+        vsids.Scale(1e-100);
+        activityIncrement *= 1e-100;
+    }
+}
+
+// увеличение активности переменных клаузы
+void ConjunctiveNormalForm::BumpClause(int clause) {
+    const int *clauseLiterals = GetClauseLiterals(clause);
+
+    for (int i = 0; i < clauses[clause].size; i++)
+        BumpVariable(clauseLiterals[i] >> 1);
+}
+
+// экспоненциальное затухание активностей (вместо уменьшения всех активностей увеличиваем шаг)
+void ConjunctiveNormalForm::DecayActivity() {
+    activityIncrement /= activityDecay;
+    clauseActivityIncrement /= clauseActivityDecay;
+}
+
+// число различных уровней решений в клаузе
+int ConjunctiveNormalForm::GetLBD(const std::vector<int> &clause) {
+    levelStamp++;
+    int lbd = 0;
+
+    for (auto it = clause.begin(); it != clause.end(); it++) {
+        int clauseLevel = levels[*it >> 1];
+
+        if (levelStamps[clauseLevel] != levelStamp) {
+            levelStamps[clauseLevel] = levelStamp;
+            lbd++;
+        }
+    }
+
+    return lbd;
+}
+
+// сброс статистики и состояния перезапусков перед поиском
+void ConjunctiveNormalForm::InitSearch() {
+    statistics = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    instrumentation = InstrumentationStatistics();
+    searchStart = std::chrono::steady_clock::now();
+    stopReason = StopReason::None;
+    deadline = searchStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(limits.time));
+    limitCheckCountdown = limitCheckInterval;
+    conflictsSinceRestart = 0;
+    restartLimit = restartInterval;
+    fastLBD = 0;
+    lbdSum = 0;
+    clauseActivityIncrement = 1;
+    nextReduction = reduceInterval;
+    statistics.peakDatabaseBytes = GetDatabaseBytes();
+}
+
+// проверка внешнего флага остановки и ограничений поиска
+bool ConjunctiveNormalForm::CheckInterrupt() {
+    if (interruptFlag != nullptr && interruptFlag->load(std::memory_order_relaxed)) {
+        stopReason = StopReason::Interrupt;
+    }
+    else if (limits.conflicts > 0 && statistics.conflicts >= limits.conflicts) {
+        stopReason = StopReason::ConflictLimit;
+    }
+    else if (limits.decisions > 0 && statistics.decisions >= limits.decisions) {
+        stopReason = StopReason::DecisionLimit;
+    }
+    else if (--limitCheckCountdown == 0) { // часы и объём базы дороже счётчиков, смотрим их реже
+        limitCheckCountdown = limitCheckInterval;
+
+        if (limits.time > 0 && std::chrono::steady_clock::now() >= deadline) {
+            stopReason = StopReason::TimeLimit;
+        }
+        else if (limits.memory > 0 && GetDatabaseBytes() > limits.memory) {
+            stopReason = StopReason::MemoryLimit;
+        }
+    }
+
+    return stopReason != StopReason::None;
+}
+
+// сброс всех присваиваний перед новым поиском
+void ConjunctiveNormalForm::ResetAssignments() {
+    for (int i = 1; i <= literalsCount; i++)
+        if (values[i] != TermValue::Undefined)
+            UnassignLiteral(2 * i + (values[i] == TermValue::False));
+
+    propagationQueue = std::queue<int>();
+    level = 0;
+    assumptionsLevel = 0;
+    assumptionIndex = 0;
+}
+
+// присваивание предположения на новом уровне
+void ConjunctiveNormalForm::AssignAssumption(int literal, std::stack<int> &assignments, std::stack<Assignment> &decisions) {
+    // предположение - решение, вторая ветвь которого не перебирается
+    decisions.push({ literal, false, literal & 1 ? TermValue::False : TermValue::True });
+    assignments.push(literal);
+    level = decisions.size();
+    AssignLiteral(literal, -1);
+}
+
+// присваивание предположений на отдельных уровнях (false при противоречии)
+bool ConjunctiveNormalForm::AssignAssumptions(const std::vector<int> &assumptions, std::stack<int> &assignments, std::stack<Assignment> &decisions) {
+    for (auto it = assumptions.begin(); it != assumptions.end(); it++) {
+        if (!UnitPropagation(assignments) || GetLiteralValue(*it) == TermValue::False)
+            return false;
 
-        for (auto j = clauses[i].begin(); j != clauses[i].end(); j++) {
-            weights[abs(*j)] += weight;
-        }
+        if (GetLiteralValue(*it) == TermValue::Undefined) // иначе уже следует из предыдущих предположений
+            AssignAssumption(*it, assignments, decisions);
     }
 
-    int literal = 0;
+    assumptionsLevel = decisions.size();
+    return true;
+}
 
-    for (auto it = weights.begin(); it != weights.end(); it++) {
-        if (values[abs(it->first)] != TermValue::Undefined)
-            continue;
+// поиск предположений, из которых следует отрицание предположения literal
+void ConjunctiveNormalForm::AnalyzeFinal(int literal, std::stack<int> &assignments) {
+    failedAssumptions.assign(1, literal);
+    seen[literal >> 1] = true;
+
+    // идём по следу назад: решения выше нулевого уровня - это предположения
+    while (!assignments.empty() && levels[assignments.top() >> 1] > 0) {
+        int assigned = assignments.top();
+        int variable = assigned >> 1;
+
+        if (seen[variable]) {
+            if (reasons[variable] < 0) {
+                failedAssumptions.push_back(assigned);
+            }
+            else {
+                const int *clauseLiterals = GetClauseLiterals(reasons[variable]);
+
+                for (int i = 0; i < clauses[reasons[variable]].size; i++)
+                    if ((clauseLiterals[i] >> 1) != variable && levels[clauseLiterals[i] >> 1] > 0)
+                        seen[clauseLiterals[i] >> 1] = true;
+            }
+
+            seen[variable] = false;
+        }
 
-        if (literal == 0 || it->second > weights[literal])
-            literal = it->first;
+        UnassignLiteral(assigned);
+        assignments.pop();
     }
 
-    return literal;
+    seen[literal >> 1] = false;
 }
 
-// литерал по стратегии Up
-int ConjunctiveNormalForm::GetUpLiteral() const {
-    int literal = 0;
+// расширение структур под новые переменные
+void ConjunctiveNormalForm::GrowVariables(int variablesCount) {
+    if (variablesCount <= literalsCount)
+        return;
 
-    for (auto it = up.begin(); it != up.end(); it++) {
-        if (GetLiteralValue(it->first) != TermValue::Undefined)
-            continue;
+    values.resize(variablesCount + 1, TermValue::Undefined);
+    literalValues.resize(2 * variablesCount + 2, TermValue::Undefined);
+    levels.resize(variablesCount + 1, 0);
+    reasons.resize(variablesCount + 1, -1);
+    seen.resize(variablesCount + 1, false);
+    levelStamps.resize(variablesCount + 1, 0);
+    savedPhases.resize(variablesCount + 1, TermValue::Undefined);
+    up.resize(variablesCount + 1, 0);
+    eliminated.resize(variablesCount + 1, false);
+    l2c.resize(2 * variablesCount + 2);
+    watches.resize(2 * variablesCount + 2);
+    implications.resize(2 * variablesCount + 2);
+    vsids.Grow(variablesCount);
+
+    for (int i = literalsCount + 1; i <= variablesCount; i++)
+        vsids.Insert(i);
+
+    literalsCount = variablesCount;
+}
+
+// подключение добавленных клауз перед выученными
+void ConjunctiveNormalForm::AttachPendingClauses() {
+    if (pendingClauses.empty())
+        return;
+
+    if (proof != nullptr)
+        throw std::string("proof can not be written for clauses added after reading");
+
+    // выученные клаузы временно убираем, чтобы исходные оставались в начале массива
+    int shift = pendingClauses.size();
+    int base = clauses.size() > originalClausesCount ? clauses[originalClausesCount].offset : literals.size();
+    std::vector<int> learnedLiterals(literals.begin() + base, literals.end());
+    std::vector<Clause> learnedHeaders(clauses.begin() + originalClausesCount, clauses.end());
+
+    literals.resize(base);
+    clauses.resize(originalClausesCount);
+
+    for (auto watchList = watches.begin(); watchList != watches.end(); watchList++)
+        for (auto it = watchList->begin(); it != watchList->end(); it++)
+            if (*it >= originalClausesCount)
+                *it += shift;
+
+    for (auto implicationList = implications.begin(); implicationList != implications.end(); implicationList++)
+        for (auto it = implicationList->begin(); it != implicationList->end(); it++)
+            if (it->clause >= originalClausesCount)
+                it->clause += shift;
+
+    for (int i = 1; i <= literalsCount; i++)
+        if (reasons[i] >= originalClausesCount)
+            reasons[i] += shift;
 
-        if (literal == 0 || it->second > up.at(literal))
-            literal = it->first;
+    for (auto clause = pendingClauses.begin(); clause != pendingClauses.end(); clause++) {
+        int index = clauses.size();
+        AppendClause(*clause);
+
+        for (auto it = clause->begin(); it != clause->end(); it++)
+            l2c[*it].push_back(index);
+
+        WatchClause(index);
     }
 
-    return literal;
+    int newBase = literals.size();
+    literals.insert(literals.end(), learnedLiterals.begin(), learnedLiterals.end());
+
+    for (auto it = learnedHeaders.begin(); it != learnedHeaders.end(); it++)
+        clauses.push_back({ it->offset - base + newBase, it->size });
+
+    originalClausesCount += shift;
+    lookAheadStamps.resize(originalClausesCount, 0);
+    clausesCount = originalClausesCount;
+    pendingClauses.clear();
 }
 
-// литерал по стратегии AUPC
-int ConjunctiveNormalForm::GetAUPCLiteral() const {
-    std::unordered_map<int, int> counts;
+// отдача ближайшей к корню неисследованной ветви
+bool ConjunctiveNormalForm::DonateSubtree(std::stack<Assignment> &decisions) {
+    std::stack<Assignment> reversed;
 
-    for (int i = 1; i <= literalsCount; i++)
-        counts[i] = 0;
+    while (!decisions.empty()) {
+        reversed.push(decisions.top());
+        decisions.pop();
+    }
 
-    for (size_t i = 0; i < clauses.size(); i++) {
-        if (IsRemovedClause(i) || GetClauseSize(i) != 2)
-            continue;
+    std::vector<int> cube; // путь до отдаваемой ветви
+    bool donated = false;
+
+    while (!reversed.empty()) {
+        Assignment decision = reversed.top();
+        reversed.pop();
 
-        for (auto j = clauses[i].begin(); j != clauses[i].end(); j++) {
-            counts[abs(*j)]++;
+        if (!donated) {
+            if (decision.isFirst) { // вторую ветвь отдаём, сами её уже не перебираем
+                cube.push_back(decision.literal ^ 1);
+                decision.isFirst = false;
+                donated = true;
+            }
+            else {
+                cube.push_back(decision.literal);
+            }
         }
+
+        decisions.push(decision);
     }
 
-    int literal = 0;
+    if (donated)
+        splitHandler(cube);
 
-    for (auto it = counts.begin(); it != counts.end(); it++) {
-        if (values[abs(it->first)] != TermValue::Undefined)
-            continue;
+    return donated;
+}
+
+// учёт конфликта для перезапусков (lbd = 0, если клауза не выучена)
+void ConjunctiveNormalForm::AddConflict(int lbd) {
+    statistics.conflicts++;
+    conflictsSinceRestart++;
 
-        if (literal == 0 || it->second > counts[literal])
-            literal = it->first;
+    if (lbd > 0) {
+        fastLBD += (lbd - fastLBD) * fastLBDDecay;
+        lbdSum += lbd;
     }
 
-    return literal;
+    if (progressInterval > 0 && statistics.conflicts % progressInterval == 0)
+        PrintProgress();
 }
 
-// выбор литерала для разветвления
-int ConjunctiveNormalForm::GetDecisionLiteral(DecisionStrategy strategy) const {
-    if (strategy == DecisionStrategy::First)
-        return GetFirstUndefinedLiteral();
-
-    if (strategy == DecisionStrategy::Random)
-        return GetRandomUndefinedLiteral();
+// строка прогресса в поток ошибок
+void ConjunctiveNormalForm::PrintProgress() const {
+    double seconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - searchStart).count() / 1000.0;
 
-    if (strategy == DecisionStrategy::Max)
-        return GetMaxOccurencesLiteral();
+    std::cerr << "c " << std::fixed << std::setprecision(2) << std::setw(8) << seconds << " s";
+    std::cerr << " | conflicts " << statistics.conflicts << ", decisions " << statistics.decisions << ", propagations " << statistics.propagations;
+    std::cerr << ", restarts " << statistics.restarts << ", learned " << clauses.size() - originalClausesCount << ", level " << level << std::endl;
+    std::cerr.unsetf(std::ios::floatfield);
+}
 
-    if (strategy == DecisionStrategy::Moms)
-        return GetMomsOccurencesLiteral();
+// пора ли перезапускаться
+bool ConjunctiveNormalForm::NeedRestart() const {
+    if (restartPolicy == RestartPolicy::None)
+        return false;
 
-    if (strategy == DecisionStrategy::Weighted)
-        return GetWeightedLiteral();
+    if (restartPolicy == RestartPolicy::Glucose) // недавние клаузы хуже средних - поиск застрял
+        return conflictsSinceRestart >= glucoseMinConflicts && fastLBD * glucoseFactor > lbdSum / statistics.conflicts;
 
-    if (strategy == DecisionStrategy::Up)
-        return GetUpLiteral();
+    return conflictsSinceRestart >= restartLimit;
+}
 
-    if (strategy == DecisionStrategy::AUPC)
-        return GetAUPCLiteral();
+// перезапуск: откат на нулевой уровень
+void ConjunctiveNormalForm::Restart(std::stack<int> &assignments, std::stack<Assignment> &decisions) {
+    BackJump(assignments, decisions, assumptionsLevel);
+    statistics.restarts++;
+    conflictsSinceRestart = 0;
 
-    return GetFirstUndefinedLiteral();
+    if (restartPolicy == RestartPolicy::Luby) {
+        restartLimit = restartInterval * Luby(2, statistics.restarts);
+    }
+    else if (restartPolicy == RestartPolicy::Geometric) {
+        restartLimit *= restartGrowth;
+    }
 }
 
 // откат
 bool ConjunctiveNormalForm::RollBack(std::stack<int> &assignments, std::stack<Assignment> &decisions) {
+    INSTRUMENT_SCOPE(instrumentation, BacktrackPhase);
+    INSTRUMENT(instrumentation.backtracks++);
+
     while (decisions.size()) {
         // удаляем все присваивания, выполненные на последнем разделении
         while (assignments.top() != decisions.top().literal) {
-            values[abs(assignments.top())] = TermValue::Undefined;
+            UnassignLiteral(assignments.top());
             assignments.pop();
         }
 
@@ -616,44 +2650,533 @@ bool ConjunctiveNormalForm::RollBack(std::stack<int> &assignments, std::stack<As
 
         if (decision.isFirst) { // сли это была первая ветвь
             decision.isFirst = false;
-            values[abs(decision.literal)] = decision.value == TermValue::True ? TermValue::False : TermValue::True; // заменяем на противоположное;
+            decision.literal ^= 1; // заменяем на противоположное
+            decision.value = decision.value == TermValue::True ? TermValue::False : TermValue::True;
+            assignments.top() = decision.literal;
+            AssignLiteral(decision.literal, -1);
             return true;
         }
 
         // иначе попробовали оба варианта
-        values[abs(decision.literal)] = TermValue::Undefined; // сбрасываем переменную
+        UnassignLiteral(decision.literal); // сбрасываем переменную
         assignments.pop(); // извлекаем присваивание
         decisions.pop(); // извлекаем выбор
+        level = decisions.size();
+
+        if (proof != nullptr) // обе ветви опровергнуты - опровергнуты и оставшиеся решения (на корне - пустая клауза)
+            WriteDecisionsClause(decisions);
     }
 
     return false; // откатываться некуда
 }
 
+// запись в доказательство отрицания решений (DPLL)
+void ConjunctiveNormalForm::WriteDecisionsClause(std::stack<Assignment> decisions) {
+    proofClause.clear();
+
+    for (; !decisions.empty(); decisions.pop())
+        proofClause.push_back(decisions.top().literal ^ 1);
+
+    proof->AddClause(proofClause);
+}
+
 // разветвление
 void ConjunctiveNormalForm::Decision(std::stack<int> &assignments, std::stack<Assignment> &decisions, DecisionStrategy strategy) {
-    int literal = GetDecisionLiteral(strategy);
-    TermValue value = literal > 0 ? TermValue::True : TermValue::False;
+    int literal = strategy == DecisionStrategy::LookAhead ? GetLookAheadLiteral(assignments, decisions) : GetDecisionLiteral(strategy);
+
+    if (literal == 0)
+        return; // просмотр вперёд присвоил литерал без разветвления, сначала его распространяем
+
+    TermValue value = literal & 1 ? TermValue::False : TermValue::True;
 
     decisions.push({ literal, true, value });
     assignments.push(literal);
-    values[abs(literal)] = value;
+    statistics.decisions++;
+    level = decisions.size();
+    INSTRUMENT(instrumentation.maxDepth = std::max(instrumentation.maxDepth, level));
+    AssignLiteral(literal, -1);
+}
+
+// анализ конфликта по первой точке доминирования (1-UIP), возвращает уровень для отката
+int ConjunctiveNormalForm::AnalyzeConflict(std::stack<int> &assignments, std::vector<int> &learned) {
+    INSTRUMENT_SCOPE(instrumentation, AnalysisPhase);
+
+    learned.assign(1, 0); // место под утверждающий литерал
+
+    int clause = conflictClause;
+    int literal = -1;
+    int pathCount = 0; // число отмеченных литералов текущего уровня
+
+    do {
+        const int *clauseLiterals = GetClauseLiterals(clause);
+        BumpClauseActivity(clause);
+
+        for (int i = 0; i < clauses[clause].size; i++) {
+            int variable = clauseLiterals[i] >> 1;
+
+            if (clauseLiterals[i] == literal || seen[variable] || levels[variable] == 0)
+                continue;
+
+            seen[variable] = true;
+            BumpVariable(variable);
+
+            if (levels[variable] == level) {
+                pathCount++;
+            }
+            else {
+                learned.push_back(clauseLiterals[i]);
+            }
+        }
+
+        // снимаем присваивания текущего уровня до следующего отмеченного литерала
+        while (!seen[assignments.top() >> 1]) {
+            UnassignLiteral(assignments.top());
+            assignments.pop();
+        }
+
+        literal = assignments.top();
+        clause = reasons[literal >> 1];
+        seen[literal >> 1] = false;
+        UnassignLiteral(literal);
+        assignments.pop();
+        pathCount--;
+    } while (pathCount > 0);
+
+    learned[0] = literal ^ 1;
+
+    int backjumpLevel = 0;
+
+    // литерал с наибольшим уровнем ставим вторым, чтобы он стал наблюдаемым
+    for (size_t i = 1; i < learned.size(); i++) {
+        seen[learned[i] >> 1] = false;
+
+        if (levels[learned[i] >> 1] > backjumpLevel) {
+            backjumpLevel = levels[learned[i] >> 1];
+            std::swap(learned[1], learned[i]);
+        }
+    }
+
+    return backjumpLevel;
+}
+
+// нехронологический откат
+void ConjunctiveNormalForm::BackJump(std::stack<int> &assignments, std::stack<Assignment> &decisions, int backjumpLevel) {
+    INSTRUMENT_SCOPE(instrumentation, BacktrackPhase);
+    INSTRUMENT(instrumentation.backtracks++);
+
+    while (!assignments.empty() && levels[assignments.top() >> 1] > backjumpLevel) {
+        UnassignLiteral(assignments.top());
+        assignments.pop();
+    }
+
+    while (decisions.size() > backjumpLevel)
+        decisions.pop();
+
+    level = backjumpLevel;
+    assumptionIndex = 0; // снятые предположения выставятся заново
+}
+
+// добавление выученной клаузы
+void ConjunctiveNormalForm::LearnClause(const std::vector<int> &learned, std::stack<int> &assignments, int lbd) {
+    int index = clauses.size();
+    AppendClause(learned);
+    learnedClauses.push_back({ lbd, clauseActivityIncrement });
+    statistics.learnedClauses++;
+
+    if (proof != nullptr)
+        proof->AddClause(learned);
+
+    statistics.peakDatabaseBytes = std::max(statistics.peakDatabaseBytes, GetDatabaseBytes());
+
+    if (useCounters)
+        AddClauseToCounters(index);
+
+    WatchClause(index);
+    PropagateLiteral(learned[0], index, assignments); // выученная клауза единична после отката
+}
+
+// увеличение активности выученной клаузы
+void ConjunctiveNormalForm::BumpClauseActivity(int clause) {
+    if (clause < originalClausesCount)
+        return;
+
+    LearnedClause &learnedClause = learnedClauses[clause - originalClausesCount];
+    learnedClause.activity += clauseActivityIncrement;
+
+    if (learnedClause.activity > 1e20) { // избегаем переполнения
+        for (auto it = learnedClauses.begin(); it != learnedClauses.end(); it++)
+            it->activity *= 1e-20;
+
+        clauseActivityIncrement *= 1e-20;
+    }
+}
+
+// объём базы клауз (байт)
+size_t ConjunctiveNormalForm::GetDatabaseBytes() const {
+    return literals.size() * sizeof(int) + clauses.size() * sizeof(Clause) + learnedClauses.size() * sizeof(LearnedClause);
+}
+
+// пора ли чистить базу выученных клауз
+bool ConjunctiveNormalForm::NeedReduce() const {
+    return statistics.conflicts >= nextReduction;
+}
+
+// удаление худшей половины выученных клауз
+void ConjunctiveNormalForm::ReduceDatabase() {
+    std::vector<bool> removed(clauses.size(), false);
+    std::vector<bool> locked(clauses.size(), false);
+    std::vector<int> candidates;
+
+    // клаузы-причины текущих присваиваний удалять нельзя
+    for (int i = 1; i <= literalsCount; i++)
+        if (values[i] != TermValue::Undefined && reasons[i] >= originalClausesCount)
+            locked[reasons[i]] = true;
+
+    for (int i = originalClausesCount; i < clauses.size(); i++)
+        if (!locked[i] && learnedClauses[i - originalClausesCount].lbd > glueLBD)
+            candidates.push_back(i);
+
+    // худшие - с большим LBD, при равенстве - с меньшей активностью
+    std::sort(candidates.begin(), candidates.end(), [this](int a, int b) {
+        const LearnedClause &clause1 = learnedClauses[a - originalClausesCount];
+        const LearnedClause &clause2 = learnedClauses[b - originalClausesCount];
+
+        if (clause1.lbd != clause2.lbd)
+            return clause1.lbd > clause2.lbd;
+
+        return clause1.activity < clause2.activity;
+    });
+
+    size_t count = std::min(candidates.size(), (clauses.size() - originalClausesCount) / 2);
+
+    for (size_t i = 0; i < count; i++) {
+        removed[candidates[i]] = true;
+
+        if (proof != nullptr)
+            proof->DeleteClause(GetClauseLiterals(candidates[i]), clauses[candidates[i]].size);
+    }
+
+    // новые номера оставшихся клауз (-1 для удалённых)
+    std::vector<int> indices(clauses.size(), -1);
+    int index = 0;
+
+    for (size_t i = 0; i < clauses.size(); i++) {
+        if (removed[i])
+            continue;
+
+        if (i >= originalClausesCount)
+            learnedClauses[index - originalClausesCount] = learnedClauses[i - originalClausesCount];
+
+        indices[i] = index++;
+    }
+
+    learnedClauses.resize(index - originalClausesCount);
+    RemoveClauses(removed);
+
+    for (auto watchList = watches.begin(); watchList != watches.end(); watchList++) {
+        size_t j = 0;
+
+        for (size_t i = 0; i < watchList->size(); i++)
+            if (indices[(*watchList)[i]] >= 0)
+                (*watchList)[j++] = indices[(*watchList)[i]];
+
+        watchList->resize(j);
+    }
+
+    // бинарные клаузы имеют LBD не больше 2 и не удаляются, меняются только их номера
+    for (auto implicationList = implications.begin(); implicationList != implications.end(); implicationList++)
+        for (auto it = implicationList->begin(); it != implicationList->end(); it++)
+            it->clause = indices[it->clause];
+
+    for (int i = 1; i <= literalsCount; i++)
+        if (reasons[i] >= 0)
+            reasons[i] = indices[reasons[i]];
+
+    if (useCounters)
+        InitCounters(); // счётчики хранят номера клауз
+
+    statistics.deletedClauses += count;
+    statistics.reductions++;
+    nextReduction = statistics.conflicts + reduceInterval + reduceIncrement * statistics.reductions;
+}
+
+// можно ли решить DPLL битовым движком
+bool ConjunctiveNormalForm::CanUseBitParallel(const std::vector<int> &assumptions) const {
+    // движок не пишет доказательство, не принимает предположений и не отдаёт ветви другим потокам
+    return bitParallel && literalsCount <= BitParallelSolver::MAX_VARIABLES && assumptions.empty() && proof == nullptr && splitFlag == nullptr;
+}
+
+// DPLL битовым движком по исходным клаузам
+Verdict ConjunctiveNormalForm::BitParallelDPLL() {
+    BitParallelSolver solver(literalsCount, originalClausesCount);
+
+    for (int i = 0; i < originalClausesCount; i++)
+        solver.AddClause(GetClauseLiterals(i), clauses[i].size);
+
+    bool isSat = solver.Solve(statistics.decisions, statistics.conflicts, statistics.propagations, instrumentation, [this]() {
+        return CheckInterrupt();
+    });
+
+    if (stopReason != StopReason::None)
+        return Verdict::Unknown;
+
+    if (!isSat)
+        return Verdict::Unsat;
+
+    SetExternalModel([&solver](int variable) { return solver.GetValue(variable); });
+    return Verdict::Sat;
 }
 
 // алгоритм DPLL
-bool ConjunctiveNormalForm::DPLL(DecisionStrategy strategy) {
+Verdict ConjunctiveNormalForm::DPLL(DecisionStrategy strategy, const std::vector<int> &assumptions) {
     std::stack<int> assignments;
     std::stack<Assignment> decisions;
 
+    if (restartPolicy == RestartPolicy::Glucose)
+        throw std::string("glucose restarts require CDCL");
+
+    if (proof != nullptr && !assumptions.empty())
+        throw std::string("proof can not be written for search under assumptions");
+
+    ResetAssignments();
+    AttachPendingClauses();
+    InitSearch();
+    learning = false;
+    bitParallelUsed = CanUseBitParallel(assumptions);
+
+    if (bitParallelUsed)
+        return BitParallelDPLL();
+
+    if (IsCountingStrategy(strategy))
+        InitCounters();
+
+    if (!AssignUnitClauses(assignments)) {
+        if (proof != nullptr)
+            proof->AddClause(nullptr, 0); // пустая клауза выводится распространением исходных единичных
+
+        return Verdict::Unsat; // противоречие без единого разветвления
+    }
+
+    failedAssumptions.clear();
+
+    if (!AssignAssumptions(assumptions, assignments, decisions)) {
+        failedAssumptions = assumptions; // без анализа противоречивым считается весь набор
+        return Verdict::Unsat; // предположения противоречат формуле
+    }
+
     while (true) {
-        if (!UnitPropagation(assignments)) // распространяем единичные литералы
+        if (CheckInterrupt()) // другой поток уже нашёл ответ или исчерпаны ограничения
+            return Verdict::Unknown;
+
+        if (!UnitPropagation(assignments)) { // распространяем единичные литералы, если конфликт
+            BumpClause(conflictClause);
+            DecayActivity();
+            AddConflict(0);
+
+            if (proof != nullptr) // текущие решения приводят к конфликту распространением
+                WriteDecisionsClause(decisions);
+
+            if (!RollBack(assignments, decisions)) { // если откатываться стало некуда
+                failedAssumptions = assumptions;
+                return Verdict::Unsat; // невыполнима
+            }
+        }
+        else if (assignments.size() == literalsCount) { // если решение
+            ExtendModel();
+            return Verdict::Sat; // то выполнима
+        }
+        else if (NeedRestart()) { // перезапуск только после распространения, когда очередь пуста
+            Restart(assignments, decisions);
+        }
+        else {
+            if (splitFlag != nullptr && splitFlag->load(std::memory_order_relaxed)) // другой поток простаивает
+                DonateSubtree(decisions);
+
             Decision(assignments, decisions, strategy); // разветвляемся
+        }
+    }
+}
 
-        if (IsConflict(-assignments.top())) { // если конфликт
-            if (!RollBack(assignments, decisions)) // если откатываться стало некуда
-                return false; // невыполнима
+// алгоритм CDCL (обучение на конфликтах)
+Verdict ConjunctiveNormalForm::CDCL(DecisionStrategy strategy, const std::vector<int> &assumptions) {
+    std::stack<int> assignments;
+    std::stack<Assignment> decisions;
+    std::vector<int> learned;
+
+    if (proof != nullptr && !assumptions.empty())
+        throw std::string("proof can not be written for search under assumptions");
+
+    ResetAssignments();
+    AttachPendingClauses();
+    InitSearch();
+    learning = true;
+    bitParallelUsed = false;
+    failedAssumptions.clear();
+
+    if (IsCountingStrategy(strategy))
+        InitCounters();
+
+    if (!AssignUnitClauses(assignments)) {
+        if (proof != nullptr)
+            proof->AddClause(nullptr, 0); // пустая клауза выводится распространением исходных единичных
+
+        return Verdict::Unsat; // противоречие без единого разветвления
+    }
+
+    while (true) {
+        if (CheckInterrupt()) // другой поток уже нашёл ответ или исчерпаны ограничения
+            return Verdict::Unknown;
+
+        if (!UnitPropagation(assignments)) { // распространяем единичные литералы, если конфликт
+            if (decisions.empty()) { // конфликт без разветвлений
+                if (proof != nullptr)
+                    proof->AddClause(nullptr, 0);
+
+                return Verdict::Unsat; // невыполнима
+            }
+
+            int backjumpLevel = AnalyzeConflict(assignments, learned);
+            int lbd = GetLBD(learned);
+            AddConflict(lbd);
+            BackJump(assignments, decisions, backjumpLevel);
+            LearnClause(learned, assignments, lbd);
+            DecayActivity();
         }
         else if (assignments.size() == literalsCount) { // если решение
-            return true; // то выполнима
+            for (auto it = assumptions.begin(); it != assumptions.end(); it++) {
+                if (GetLiteralValue(*it) == TermValue::False) { // предположение опровергнуто распространением
+                    AnalyzeFinal(*it, assignments);
+                    return Verdict::Unsat;
+                }
+            }
+
+            ExtendModel();
+            return Verdict::Sat; // то выполнима
         }
+        else if (NeedRestart()) { // перезапуск только после распространения, когда очередь пуста
+            Restart(assignments, decisions);
+        }
+        else if (NeedReduce()) { // чистка базы тоже только после распространения, причины присваиваний известны
+            ReduceDatabase();
+        }
+        else {
+            while (assumptionIndex < assumptions.size() && GetLiteralValue(assumptions[assumptionIndex]) == TermValue::True)
+                assumptionIndex++;
+
+            if (assumptionIndex == assumptions.size()) {
+                Decision(assignments, decisions, strategy); // разветвляемся
+            }
+            else if (GetLiteralValue(assumptions[assumptionIndex]) == TermValue::False) { // предположение опровергнуто
+                AnalyzeFinal(assumptions[assumptionIndex], assignments);
+                return Verdict::Unsat;
+            }
+            else { // сначала выставляем предположения
+                AssignAssumption(assumptions[assumptionIndex], assignments, decisions);
+            }
+        }
+    }
+}
+
+// локальный поиск модели по исходным клаузам (при hybrid после исчерпания бюджета - DPLL)
+Verdict ConjunctiveNormalForm::LocalSearch(const LocalSearchOptions &options, DecisionStrategy strategy) {
+    ResetAssignments();
+    AttachPendingClauses();
+    InitSearch();
+    bitParallelUsed = false;
+
+    LocalSearchSolver solver(literalsCount, originalClausesCount);
+
+    for (int i = 0; i < originalClausesCount; i++)
+        solver.AddClause(GetClauseLiterals(i), clauses[i].size);
+
+    if (solver.HasEmptyClause()) {
+        if (proof != nullptr)
+            proof->AddClause(nullptr, 0);
+
+        return Verdict::Unsat;
+    }
+
+    if (solver.Solve(options, statistics.flips, [this]() { return CheckInterrupt(); })) {
+        SetExternalModel([&solver](int variable) { return solver.GetValue(variable); });
+        return Verdict::Sat;
+    }
+
+    if (stopReason != StopReason::None)
+        return Verdict::Unknown;
+
+    stopReason = StopReason::FlipLimit;
+
+    if (!options.hybrid)
+        return Verdict::Unknown; // локальный поиск не доказывает невыполнимость
+
+    // полный поиск получает остаток времени, остальные ограничения не расходовались
+    SearchLimits searchLimits = limits;
+    long long flips = statistics.flips;
+
+    if (limits.time > 0)
+        limits.time = std::max(std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count(), 1e-6);
+
+    Verdict verdict = DPLL(strategy);
+    limits = searchLimits;
+    statistics.flips = flips;
+    return verdict;
+}
+
+// добавление клаузы (литералы в формате DIMACS) между вызовами поиска
+void ConjunctiveNormalForm::AddClause(const std::vector<int> &clause) {
+    std::vector<int> encoded;
+
+    for (auto it = clause.begin(); it != clause.end(); it++) {
+        if (*it == 0)
+            throw std::string("ConjunctiveNormalForm::AddClause: literal must be non-zero");
+
+        GrowVariables(abs(*it));
+
+        if (eliminated[abs(*it)])
+            throw std::string("ConjunctiveNormalForm::AddClause: variable ") + std::to_string(abs(*it)) + " was eliminated by preprocessing";
+
+        encoded.push_back(EncodeLiteral(*it));
+    }
+
+    int size = NormalizeClause(encoded.data(), encoded.size());
+
+    if (size < 0)
+        return; // тавтология всегда выполнена
+
+    encoded.resize(size);
+    pendingClauses.push_back(encoded);
+}
+
+// инкрементальный CDCL при предположениях (литералы в формате DIMACS)
+Verdict ConjunctiveNormalForm::Solve(const std::vector<int> &assumptions, DecisionStrategy strategy) {
+    std::vector<int> encoded;
+
+    for (auto it = assumptions.begin(); it != assumptions.end(); it++) {
+        if (*it == 0)
+            throw std::string("ConjunctiveNormalForm::Solve: assumption must be non-zero");
+
+        GrowVariables(abs(*it));
+
+        if (eliminated[abs(*it)])
+            throw std::string("ConjunctiveNormalForm::Solve: variable ") + std::to_string(abs(*it)) + " was eliminated by preprocessing";
+
+        encoded.push_back(EncodeLiteral(*it));
     }
-}
\ No newline at end of file
+
+    Verdict result = CDCL(strategy, encoded);
+
+    for (auto it = failedAssumptions.begin(); it != failedAssumptions.end(); it++)
+        *it = DecodeLiteral(*it);
+
+    return result;
+}
+
+// противоречивое подмножество предположений последнего Solve (формат DIMACS)
+const std::vector<int>& ConjunctiveNormalForm::GetFailedAssumptions() const {
+    return failedAssumptions;
+}
+
+// значение переменной в найденной модели
+TermValue ConjunctiveNormalForm::GetTermValue(int variable) const {
+    return values[variable];
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include "ConjunctiveNormalForm.hpp"
+
+// параллельный DPLL по кубам (частичным присваиваниям) с перераспределением работы между потоками
+class CubeAndConquer {
+    DecisionStrategy strategy; // стратегия выбора литерала внутри кубов
+    std::vector<ConjunctiveNormalForm> solvers; // независимые копии формулы
+    std::deque<std::vector<int>> cubes; // неразрешённые кубы (коды литералов)
+
+    std::mutex mutex; // защита очереди кубов и счётчиков потоков
+    std::condition_variable condition; // ожидание новых кубов или завершения
+    int busyWorkers; // число потоков, решающих куб
+    int waitingWorkers; // число потоков, ожидающих куб
+    std::atomic<bool> stop; // найдена модель, остальные потоки останавливаются
+    std::atomic<bool> splitRequest; // простаивающие потоки просят отдать часть дерева поиска
+    SearchLimits limits; // ограничения: время общее, остальные - на каждый куб
+    std::chrono::steady_clock::time_point start; // момент начала решения
+    bool limitReached; // какой-то куб остался нерешённым из-за ограничений
+
+    int winner; // номер потока, нашедшего модель (-1, если модели нет)
+    long long solvedCubes; // число решённых кубов
+    long long splits; // число отданных частей деревьев поиска
+
+    void GenerateCubes(const ConjunctiveNormalForm &cnf, int depth); // разбиение по самым частым переменным на верхних уровнях
+    void AddCube(const std::vector<int> &cube); // добавление отданного куба в очередь
+    void Run(int index); // работа одного потока
+public:
+    CubeAndConquer(const ConjunctiveNormalForm &cnf, int threadsCount, DecisionStrategy strategy);
+
+    Verdict Solve(); // решение, UNSAT - когда закрыты все кубы, UNKNOWN - когда куб не решён из-за ограничений
+    int GetWinner() const; // номер потока, нашедшего модель
+    const ConjunctiveNormalForm& GetSolver(int index) const; // копия формулы потока (с моделью победителя)
+    long long GetSolvedCubesCount() const; // число решённых кубов
+    long long GetSplitsCount() const; // число отданных частей деревьев поиска
+};
+
+CubeAndConquer::CubeAndConquer(const ConjunctiveNormalForm &cnf, int threadsCount, DecisionStrategy strategy) {
+    if (threadsCount <= 0)
+        throw std::string("CubeAndConquer: threads count must be positive");
+
+    this->strategy = strategy;
+    limits = cnf.GetLimits();
+    solvers.reserve(threadsCount);
+
+    for (int i = 0; i < threadsCount; i++) {
+        solvers.push_back(cnf);
+        solvers.back().SetProofWriter(nullptr); // доказательство по кубам не складывается в одно
+    }
+
+    int depth = 2; // по четыре куба на поток на старте, остальное - перераспределением
+
+    while ((1 << (depth - 2)) < threadsCount)
+        depth++;
+
+    GenerateCubes(cnf, std::min(depth, cnf.GetVariablesCount()));
+}
+
+// разбиение по самым частым переменным на верхних уровнях
+void CubeAndConquer::GenerateCubes(const ConjunctiveNormalForm &cnf, int depth) {
+    std::vector<int> variables;
+
+    for (int i = 1; i <= cnf.GetVariablesCount(); i++)
+        variables.push_back(i);
+
+    std::stable_sort(variables.begin(), variables.end(), [&cnf](int a, int b) { return cnf.GetOccurrencesCount(a) > cnf.GetOccurrencesCount(b); });
+
+    for (int mask = 0; mask < (1 << depth); mask++) {
+        std::vector<int> cube;
+
+        for (int i = 0; i < depth; i++)
+            cube.push_back(2 * variables[i] + ((mask >> i) & 1));
+
+        cubes.push_back(cube);
+    }
+}
+
+// добавление отданного куба в очередь
+void CubeAndConquer::AddCube(const std::vector<int> &cube) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cubes.push_back(cube);
+        splits++;
+        splitRequest.store(false);
+    }
+
+    condition.notify_one();
+}
+
+// работа одного потока
+void CubeAndConquer::Run(int index) {
+    ConjunctiveNormalForm &solver = solvers[index];
+
+    solver.SetInterruptFlag(&stop);
+    solver.SetSplitHandler(&splitRequest, [this](const std::vector<int> &cube) { AddCube(cube); });
+
+    while (true) {
+        std::vector<int> cube;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            waitingWorkers++;
+
+            // кубов нет, но кто-то ещё работает - просим его поделиться
+            while (cubes.empty() && busyWorkers > 0 && !stop.load()) {
+                splitRequest.store(true);
+                condition.wait(lock);
+            }
+
+            waitingWorkers--;
+
+            if (stop.load() || cubes.empty()) { // модель найдена или все кубы закрыты
+                condition.notify_all();
+                return;
+            }
+
+            cube = cubes.front();
+            cubes.pop_front();
+            busyWorkers++;
+
+            if (cubes.empty() && waitingWorkers > 0)
+                splitRequest.store(true); // остальные ожидающие по-прежнему без работы
+        }
+
+        if (limits.time > 0) { // куб получает остаток общего времени
+            SearchLimits cubeLimits = limits;
+            cubeLimits.time = std::max(1e-6, limits.time - std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            solver.SetLimits(cubeLimits);
+        }
+
+        Verdict result = solver.DPLL(strategy, cube);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+
+            if (result != Verdict::Unknown) {
+                solvedCubes++;
+
+                if (result == Verdict::Sat && winner < 0) {
+                    winner = index;
+                    stop.store(true);
+                }
+            }
+            else if (solver.GetStopReason() != StopReason::Interrupt) { // без этого куба ответ UNSAT неверен
+                limitReached = true;
+                stop.store(true);
+            }
+        }
+
+        condition.notify_all();
+    }
+}
+
+// решение, UNSAT - когда закрыты все кубы, UNKNOWN - когда куб не решён из-за ограничений
+Verdict CubeAndConquer::Solve() {
+    busyWorkers = 0;
+    waitingWorkers = 0;
+    stop.store(false);
+    splitRequest.store(false);
+    winner = -1;
+    solvedCubes = 0;
+    splits = 0;
+    limitReached = false;
+    start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < solvers.size(); i++)
+        threads.emplace_back(&CubeAndConquer::Run, this, i);
+
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    if (winner >= 0)
+        return Verdict::Sat;
+
+    return limitReached ? Verdict::Unknown : Verdict::Unsat;
+}
+
+// номер потока, нашедшего модель
+int CubeAndConquer::GetWinner() const {
+    return winner;
+}
+
+// копия формулы потока (с моделью победителя)
+const ConjunctiveNormalForm& CubeAndConquer::GetSolver(int index) const {
+    return solvers[index];
+}
+
+// число решённых кубов
+long long CubeAndConquer::GetSolvedCubesCount() const {
+    return solvedCubes;
+}
+
+// число отданных частей деревьев поиска
+long long CubeAndConquer::GetSplitsCount() const {
+    return splits;
+}
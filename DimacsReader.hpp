@@ -0,0 +1,200 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <climits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// чтение файла в формате DIMACS: отображение файла в память, чтение потока большими блоками или разбор данных в памяти
+class DimacsReader {
+    static const size_t BUFFER_SIZE = 1 << 20; // размер блока при чтении из потока
+
+    const char *position; // текущий символ
+    const char *end; // конец доступных данных
+    size_t bytesCount; // число прочитанных байт
+
+    std::istream *stream; // поток (nullptr при отображении файла)
+    std::vector<char> buffer; // буфер для чтения потока
+
+    void *mapping; // отображённый в память файл
+    size_t mappingSize; // размер отображения
+
+    bool Refill(); // чтение следующего блока потока
+public:
+    DimacsReader(const std::string &path); // отображение файла в память
+    DimacsReader(std::istream &stream); // чтение потока блоками
+    DimacsReader(const char *data, size_t size); // разбор данных в памяти без копирования
+    ~DimacsReader();
+
+    DimacsReader(const DimacsReader&) = delete;
+    DimacsReader& operator=(const DimacsReader&) = delete;
+
+    int Peek(); // текущий символ (EOF в конце данных)
+    void Skip(); // пропуск текущего символа
+    void SkipSpaces(); // пропуск пробельных символов и переводов строк
+    void SkipLine(); // пропуск до конца строки
+    void SkipWord(); // пропуск непробельных символов
+    bool ReadInt(int &value); // чтение целого числа
+
+    size_t GetBytesCount() const; // число прочитанных байт
+};
+
+DimacsReader::DimacsReader(const std::string &path) {
+    stream = nullptr;
+    mapping = nullptr;
+    mappingSize = 0;
+    bytesCount = 0;
+    position = end = nullptr;
+
+    int fd = open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+        throw std::string("unable to open file '") + path + "'";
+
+    struct stat info;
+
+    if (fstat(fd, &info) < 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        throw std::string("unable to open file '") + path + "'";
+    }
+
+    mappingSize = info.st_size;
+
+    if (mappingSize > 0) {
+        mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            throw std::string("unable to map file '") + path + "'";
+        }
+
+        madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+        position = (const char *) mapping;
+        end = position + mappingSize;
+        bytesCount = mappingSize;
+    }
+
+    close(fd); // отображение остаётся доступным после закрытия дескриптора
+}
+
+DimacsReader::DimacsReader(std::istream &stream) {
+    this->stream = &stream;
+    mapping = nullptr;
+    mappingSize = 0;
+    bytesCount = 0;
+    buffer.resize(BUFFER_SIZE);
+    position = end = buffer.data();
+}
+
+DimacsReader::DimacsReader(const char *data, size_t size) {
+    stream = nullptr;
+    mapping = nullptr;
+    mappingSize = 0;
+    bytesCount = size;
+    position = data;
+    end = data + size;
+}
+
+DimacsReader::~DimacsReader() {
+    if (mapping)
+        munmap(mapping, mappingSize);
+}
+
+// чтение следующего блока потока
+bool DimacsReader::Refill() {
+    if (stream == nullptr || !*stream)
+        return false;
+
+    stream->read(buffer.data(), buffer.size());
+    size_t count = stream->gcount();
+
+    position = buffer.data();
+    end = position + count;
+    bytesCount += count;
+
+    return count > 0;
+}
+
+// текущий символ (EOF в конце данных)
+int DimacsReader::Peek() {
+    if (position == end && !Refill())
+        return EOF;
+
+    return *position;
+}
+
+// пропуск текущего символа
+void DimacsReader::Skip() {
+    if (position != end || Refill())
+        position++;
+}
+
+// пропуск пробельных символов и переводов строк
+void DimacsReader::SkipSpaces() {
+    while (position != end || Refill()) {
+        if (*position != ' ' && *position != '\n' && *position != '\t' && *position != '\r')
+            return;
+
+        position++;
+    }
+}
+
+// пропуск до конца строки
+void DimacsReader::SkipLine() {
+    while (position != end || Refill()) {
+        if (*position++ == '\n')
+            return;
+    }
+}
+
+// пропуск непробельных символов
+void DimacsReader::SkipWord() {
+    while (position != end || Refill()) {
+        if (*position == ' ' || *position == '\n' || *position == '\t' || *position == '\r')
+            return;
+
+        position++;
+    }
+}
+
+// чтение целого числа
+bool DimacsReader::ReadInt(int &value) {
+    SkipSpaces();
+
+    bool negative = Peek() == '-';
+
+    if (negative)
+        position++;
+
+    unsigned digit;
+    int result = 0;
+    bool hasDigits = false;
+
+    // основной цикл: одна проверка на символ, блок подгружается только на границе
+    while ((position != end || Refill()) && (digit = (unsigned char) *position - '0') < 10) {
+        if (result > (INT_MAX - (int) digit) / 10) { // число не помещается в int
+            std::string number = (negative ? "-" : "") + std::to_string(result);
+
+            while ((position != end || Refill()) && (unsigned char) *position - '0' < 10u)
+                number += *position++;
+
+            throw std::string("Invalid literal index '") + number + "'";
+        }
+
+        result = result * 10 + digit;
+        position++;
+        hasDigits = true;
+    }
+
+    value = negative ? -result : result;
+    return hasDigits;
+}
+
+// число прочитанных байт
+size_t DimacsReader::GetBytesCount() const {
+    return bytesCount;
+}
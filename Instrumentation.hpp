@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+
+// замеряемые этапы поиска
+enum InstrumentedPhase {
+    PropagationPhase, // распространение констант
+    DecisionPhase, // выбор литерала для разветвления
+    BacktrackPhase, // откат (хронологический и нехронологический)
+    AnalysisPhase, // анализ конфликта
+    PhasesCount
+};
+
+// счётчики горячих участков поиска, заполняются только при сборке с -DSOLVER_INSTRUMENTATION
+struct InstrumentationStatistics {
+    long long backtracks; // число откатов
+    int maxDepth; // наибольшая глубина разветвлений
+    long long clauseVisits; // число просмотренных клауз в списках наблюдения
+    long long phaseCalls[PhasesCount]; // число входов в этапы
+    long long phaseTimes[PhasesCount]; // время этапов (нс)
+};
+
+// название этапа
+const char* InstrumentedPhaseToString(int phase) {
+    static const char *names[] = { "unit propagation", "decision", "backtrack", "conflict analysis" };
+    return names[phase];
+}
+
+#ifdef SOLVER_INSTRUMENTATION
+
+// таймер области видимости: добавляет время от создания до уничтожения к этапу
+class ScopedTimer {
+    InstrumentationStatistics &statistics; // куда записывать
+    int phase; // замеряемый этап
+    std::chrono::steady_clock::time_point start; // момент входа
+public:
+    ScopedTimer(InstrumentationStatistics &statistics, int phase) : statistics(statistics), phase(phase), start(std::chrono::steady_clock::now()) {
+    }
+
+    ~ScopedTimer() {
+        statistics.phaseCalls[phase]++;
+        statistics.phaseTimes[phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+#define INSTRUMENT(statement) statement
+#define INSTRUMENT_SCOPE(statistics, phase) ScopedTimer scopedTimer(statistics, phase)
+
+#else
+
+// без флага сборки инструментирование не порождает кода (статистика только помечается использованной)
+#define INSTRUMENT(statement)
+#define INSTRUMENT_SCOPE(statistics, phase) (void) (statistics)
+
+#endif
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <random>
+#include <climits>
+#include <algorithm>
+#include <functional>
+
+// алгоритм выбора переворачиваемой переменной
+enum class LocalSearchAlgorithm {
+    ProbSat, // случайно с весом, убывающим с числом нарушаемых клауз
+    WalkSat // переменная с наименьшим числом нарушаемых клауз, с шумом (SKC)
+};
+
+// настройки локального поиска
+struct LocalSearchOptions {
+    LocalSearchAlgorithm algorithm; // алгоритм выбора переменной
+    long long maxFlips; // бюджет переворотов (0 - без ограничения)
+    unsigned seed; // зерно генератора случайных чисел
+    bool hybrid; // решать ли DPLL после исчерпания бюджета
+};
+
+// перевод алгоритма локального поиска в строку
+std::string LocalSearchAlgorithmToString(LocalSearchAlgorithm algorithm) {
+    if (algorithm == LocalSearchAlgorithm::ProbSat)
+        return "probsat";
+
+    if (algorithm == LocalSearchAlgorithm::WalkSat)
+        return "walksat";
+
+    return "";
+}
+
+// получение алгоритма локального поиска
+LocalSearchAlgorithm GetLocalSearchAlgorithm(const std::string &algorithm) {
+    if (algorithm == "probsat")
+        return LocalSearchAlgorithm::ProbSat;
+
+    if (algorithm == "walksat")
+        return LocalSearchAlgorithm::WalkSat;
+
+    throw std::string("Invalid local search algorithm '") + algorithm + "'";
+}
+
+// стохастический локальный поиск по полному присваиванию: переворачивает переменные невыполненных клауз,
+// храня для каждой переменной число клауз, которые станут невыполненными при её перевороте (break)
+class LocalSearchSolver {
+    int variablesCount; // число переменных
+    std::vector<int> literals; // литералы клауз подряд (2 * переменная + знак)
+    std::vector<int> clauseStarts; // начала клауз в literals (на одно больше, чем клауз)
+    bool hasEmptyClause; // есть ли пустая клауза
+    std::vector<int> occurrenceStarts; // начала списков вхождений по кодам литералов
+    std::vector<int> occurrences; // номера клауз, содержащих литерал, подряд по кодам литералов
+
+    std::vector<char> values; // значения переменных (1 - истина)
+    std::vector<int> trueCounts; // число истинных литералов клауз
+    std::vector<int> criticalVariables; // XOR переменных истинных литералов клаузы: при одном истинном литерале - его переменная
+    std::vector<int> breaks; // число клауз, в которых переменная даёт единственный истинный литерал
+    std::vector<int> unsatClauses; // невыполненные клаузы
+    std::vector<int> unsatPositions; // позиции клауз в unsatClauses (-1 для выполненных)
+
+    std::mt19937 generator; // генератор случайных чисел
+    std::vector<double> breakWeights; // веса probSAT по числу нарушаемых клауз
+    std::vector<double> candidateWeights; // веса переменных выбранной клаузы
+    const int maxBreakWeight = 64; // больше нарушаемых клауз - тот же (почти нулевой) вес
+    const double walkSatNoise = 0.567; // вероятность случайного шага WalkSAT, если каждый переворот что-то нарушает
+
+    void FillOccurrences(); // построение списков вхождений по литералам клауз
+    void FillBreakWeights(); // веса probSAT по наибольшей длине клауз
+    void InitAssignment(); // случайное присваивание и счётчики
+    void AddUnsatClause(int clause); // добавление клаузы в список невыполненных
+    void RemoveUnsatClause(int clause); // удаление клаузы из списка невыполненных (перенос последней на её место)
+    void Flip(int variable); // переворот переменной с обновлением счётчиков
+    int GetProbSatVariable(int clause); // переменная клаузы с вероятностью, пропорциональной весу её break
+    int GetWalkSatVariable(int clause); // переменная клаузы с наименьшим break или случайная с вероятностью шума
+public:
+    LocalSearchSolver(int variablesCount, int expectedClausesCount = 0);
+
+    void AddClause(const int *clause, int size); // добавление клаузы (коды литералов 2 * переменная + знак)
+    bool Solve(const LocalSearchOptions &options, long long &flips, const std::function<bool()> &stop); // поиск модели (false, если бюджет исчерпан, есть пустая клауза или stop вернул true)
+    bool HasEmptyClause() const; // есть ли пустая клауза
+    bool GetValue(int variable) const; // значение переменной при текущем присваивании
+};
+
+LocalSearchSolver::LocalSearchSolver(int variablesCount, int expectedClausesCount) {
+    this->variablesCount = variablesCount;
+    hasEmptyClause = false;
+    clauseStarts.reserve(expectedClausesCount + 1);
+    clauseStarts.push_back(0);
+}
+
+// добавление клаузы (коды литералов 2 * переменная + знак)
+void LocalSearchSolver::AddClause(const int *clause, int size) {
+    size_t offset = literals.size();
+
+    for (int i = 0; i < size; i++) {
+        auto end = literals.end();
+
+        if (std::find(literals.begin() + offset, end, clause[i] ^ 1) != end) {
+            literals.resize(offset); // тавтология всегда выполнена
+            return;
+        }
+
+        // повторный литерал сломал бы XOR истинных переменных
+        if (std::find(literals.begin() + offset, end, clause[i]) == end)
+            literals.push_back(clause[i]);
+    }
+
+    if (size == 0)
+        hasEmptyClause = true;
+
+    clauseStarts.push_back(literals.size());
+}
+
+// построение списков вхождений по литералам клауз
+void LocalSearchSolver::FillOccurrences() {
+    int clausesCount = clauseStarts.size() - 1;
+    occurrenceStarts.assign(2 * variablesCount + 3, 0);
+
+    for (auto it = literals.begin(); it != literals.end(); it++)
+        occurrenceStarts[*it + 1]++;
+
+    for (int literal = 0; literal < 2 * variablesCount + 2; literal++)
+        occurrenceStarts[literal + 1] += occurrenceStarts[literal];
+
+    std::vector<int> positions(occurrenceStarts.begin(), occurrenceStarts.end() - 1);
+    occurrences.resize(literals.size());
+
+    for (int i = 0; i < clausesCount; i++)
+        for (int j = clauseStarts[i]; j < clauseStarts[i + 1]; j++)
+            occurrences[positions[literals[j]]++] = i;
+}
+
+// веса probSAT по наибольшей длине клауз (параметры Balint и Schöning для случайных k-КНФ)
+void LocalSearchSolver::FillBreakWeights() {
+    int maxSize = 0;
+
+    for (size_t i = 0; i + 1 < clauseStarts.size(); i++)
+        maxSize = std::max(maxSize, clauseStarts[i + 1] - clauseStarts[i]);
+
+    breakWeights.resize(maxBreakWeight + 1);
+    candidateWeights.resize(maxSize);
+
+    for (int b = 0; b <= maxBreakWeight; b++) {
+        if (maxSize <= 3) {
+            breakWeights[b] = std::pow(1.0 + b, -2.38); // полиномиальный вес (eps + break)^-cb
+        }
+        else {
+            double cb = maxSize == 4 ? 3.0 : (maxSize == 5 ? 3.7 : (maxSize == 6 ? 5.1 : 5.4));
+            breakWeights[b] = std::pow(cb, -b); // экспоненциальный вес cb^-break
+        }
+    }
+}
+
+// случайное присваивание и счётчики
+void LocalSearchSolver::InitAssignment() {
+    int clausesCount = clauseStarts.size() - 1;
+
+    values.assign(variablesCount + 1, 0);
+    trueCounts.assign(clausesCount, 0);
+    criticalVariables.assign(clausesCount, 0);
+    breaks.assign(variablesCount + 1, 0);
+    unsatClauses.clear();
+    unsatPositions.assign(clausesCount, -1);
+
+    for (int i = 1; i <= variablesCount; i++)
+        values[i] = generator() & 1;
+
+    for (int i = 0; i < clausesCount; i++) {
+        for (int j = clauseStarts[i]; j < clauseStarts[i + 1]; j++) {
+            int literal = literals[j];
+
+            if (values[literal >> 1] != (literal & 1)) { // положительный литерал истинен при значении 1
+                trueCounts[i]++;
+                criticalVariables[i] ^= literal >> 1;
+            }
+        }
+
+        if (trueCounts[i] == 0)
+            AddUnsatClause(i);
+        else if (trueCounts[i] == 1)
+            breaks[criticalVariables[i]]++;
+    }
+}
+
+// добавление клаузы в список невыполненных
+void LocalSearchSolver::AddUnsatClause(int clause) {
+    unsatPositions[clause] = unsatClauses.size();
+    unsatClauses.push_back(clause);
+}
+
+// удаление клаузы из списка невыполненных (перенос последней на её место)
+void LocalSearchSolver::RemoveUnsatClause(int clause) {
+    int last = unsatClauses.back();
+    int position = unsatPositions[clause];
+
+    unsatClauses[position] = last;
+    unsatPositions[last] = position;
+    unsatClauses.pop_back();
+    unsatPositions[clause] = -1;
+}
+
+// переворот переменной с обновлением счётчиков
+void LocalSearchSolver::Flip(int variable) {
+    int trueLiteral = 2 * variable + values[variable]; // литерал, который станет истинным
+    values[variable] ^= 1;
+
+    for (int i = occurrenceStarts[trueLiteral]; i < occurrenceStarts[trueLiteral + 1]; i++) {
+        int clause = occurrences[i];
+        int count = trueCounts[clause]++;
+
+        if (count == 0) {
+            RemoveUnsatClause(clause);
+            breaks[variable]++;
+        }
+        else if (count == 1) {
+            breaks[criticalVariables[clause]]--; // прежний единственный истинный литерал больше не критичен
+        }
+
+        criticalVariables[clause] ^= variable;
+    }
+
+    int falseLiteral = trueLiteral ^ 1;
+
+    for (int i = occurrenceStarts[falseLiteral]; i < occurrenceStarts[falseLiteral + 1]; i++) {
+        int clause = occurrences[i];
+        int count = --trueCounts[clause];
+        criticalVariables[clause] ^= variable;
+
+        if (count == 0) {
+            AddUnsatClause(clause);
+            breaks[variable]--;
+        }
+        else if (count == 1) {
+            breaks[criticalVariables[clause]]++; // оставшийся истинный литерал стал критичным
+        }
+    }
+}
+
+// переменная клаузы с вероятностью, пропорциональной весу её break
+int LocalSearchSolver::GetProbSatVariable(int clause) {
+    const int *first = literals.data() + clauseStarts[clause];
+    const int *last = literals.data() + clauseStarts[clause + 1];
+    double sum = 0;
+
+    for (const int *it = first; it != last; it++)
+        sum += candidateWeights[it - first] = breakWeights[std::min(breaks[*it >> 1], maxBreakWeight)];
+
+    double threshold = std::uniform_real_distribution<double>(0, sum)(generator);
+
+    for (const int *it = first; it != last - 1; it++) {
+        threshold -= candidateWeights[it - first];
+
+        if (threshold < 0)
+            return *it >> 1;
+    }
+
+    return *(last - 1) >> 1;
+}
+
+// переменная клаузы с наименьшим break (из равных - случайная) или случайная с вероятностью шума
+int LocalSearchSolver::GetWalkSatVariable(int clause) {
+    const int *first = literals.data() + clauseStarts[clause];
+    int size = clauseStarts[clause + 1] - clauseStarts[clause];
+    int best = 0;
+    int bestBreak = INT_MAX;
+    int ties = 0;
+
+    for (int i = 0; i < size; i++) {
+        int value = breaks[first[i] >> 1];
+
+        if (value < bestBreak) {
+            best = i;
+            bestBreak = value;
+            ties = 1;
+        }
+        else if (value == bestBreak && generator() % ++ties == 0) {
+            best = i;
+        }
+    }
+
+    // переворот без нарушений делается всегда, иначе с вероятностью шума - случайный
+    if (bestBreak > 0 && std::uniform_real_distribution<double>(0, 1)(generator) < walkSatNoise)
+        best = generator() % size;
+
+    return first[best] >> 1;
+}
+
+// поиск модели (false, если бюджет исчерпан, есть пустая клауза или stop вернул true)
+bool LocalSearchSolver::Solve(const LocalSearchOptions &options, long long &flips, const std::function<bool()> &stop) {
+    if (hasEmptyClause)
+        return false;
+
+    generator.seed(options.seed);
+    FillOccurrences();
+    FillBreakWeights();
+    InitAssignment();
+
+    while (!unsatClauses.empty()) {
+        if ((options.maxFlips > 0 && flips >= options.maxFlips) || stop())
+            return false;
+
+        int clause = unsatClauses[generator() % unsatClauses.size()];
+        Flip(options.algorithm == LocalSearchAlgorithm::ProbSat ? GetProbSatVariable(clause) : GetWalkSatVariable(clause));
+        flips++;
+    }
+
+    return true;
+}
+
+// есть ли пустая клауза
+bool LocalSearchSolver::HasEmptyClause() const {
+    return hasEmptyClause;
+}
+
+// значение переменной при текущем присваивании
+bool LocalSearchSolver::GetValue(int variable) const {
+    return values[variable];
+}
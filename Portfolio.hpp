@@ -0,0 +1,147 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include "ConjunctiveNormalForm.hpp"
+
+// настройки одного решателя портфеля
+struct PortfolioConfiguration {
+    DecisionStrategy strategy; // стратегия выбора литерала
+    bool useCDCL; // использовать ли обучение на конфликтах
+    RestartPolicy restartPolicy; // политика перезапусков
+    bool phaseSaving; // сохранять ли фазы
+    bool bitParallel; // решать ли DPLL формул до 256 переменных битовым движком вместо стратегии
+    unsigned seed; // зерно генератора случайных чисел
+};
+
+// настройки решателя с заданным номером: сначала лучшие на разных семействах задач, затем случайные с разными зёрнами
+PortfolioConfiguration GetPortfolioConfiguration(int index) {
+    static const PortfolioConfiguration configurations[] = {
+        { DecisionStrategy::Vsids, true, RestartPolicy::Luby, true, false, 0 },
+        { DecisionStrategy::Moms, false, RestartPolicy::None, false, true, 0 }, // единственный решатель с битовым движком
+        { DecisionStrategy::Max, false, RestartPolicy::None, false, false, 0 },
+        { DecisionStrategy::Weighted, false, RestartPolicy::None, false, false, 0 },
+        { DecisionStrategy::AUPC, false, RestartPolicy::None, false, false, 0 },
+        { DecisionStrategy::Vsids, true, RestartPolicy::Glucose, true, false, 0 },
+        { DecisionStrategy::Moms, true, RestartPolicy::Luby, true, false, 0 },
+        { DecisionStrategy::First, true, RestartPolicy::Geometric, true, false, 0 }
+    };
+
+    const int count = sizeof(configurations) / sizeof(configurations[0]);
+
+    if (index < count)
+        return configurations[index];
+
+    return { DecisionStrategy::Random, true, RestartPolicy::Luby, true, false, (unsigned) index };
+}
+
+// перевод настроек решателя в строку (битовый движок указывается, только если он действительно решал формулу)
+std::string PortfolioConfigurationToString(const PortfolioConfiguration &configuration, bool bitParallelUsed) {
+    std::string result = StrategyToString(configuration.strategy) + (configuration.useCDCL ? " CDCL" : " DPLL");
+
+    if (bitParallelUsed)
+        result += " (bit-parallel engine up to " + std::to_string(BitParallelSolver::MAX_VARIABLES) + " variables)";
+
+    if (configuration.restartPolicy != RestartPolicy::None)
+        result += ", " + RestartPolicyToString(configuration.restartPolicy) + " restarts";
+
+    if (configuration.phaseSaving)
+        result += ", phase saving";
+
+    if (configuration.strategy == DecisionStrategy::Random)
+        result += ", seed " + std::to_string(configuration.seed);
+
+    return result;
+}
+
+// параллельное решение копий формулы с разными настройками, побеждает первый полученный вердикт
+class Portfolio {
+    std::vector<PortfolioConfiguration> configurations; // настройки решателей
+    std::vector<ConjunctiveNormalForm> solvers; // независимые копии формулы
+    std::atomic<bool> stop; // флаг остановки остальных потоков
+    std::atomic<int> winner; // номер первого решателя с ответом (-1, пока ответа нет)
+    Verdict verdict; // ответ победителя
+
+    void Run(int index); // работа одного потока
+public:
+    Portfolio(const ConjunctiveNormalForm &cnf, int threadsCount, bool bitParallel); // bitParallel - разрешён ли битовый движок (выключается -nosimd)
+
+    Verdict Solve(); // запуск всех решателей, возвращает ответ первого завершившегося (UNKNOWN, если все исчерпали ограничения)
+    int GetWinner() const; // номер победившего решателя
+    const PortfolioConfiguration& GetConfiguration(int index) const; // настройки решателя
+    const ConjunctiveNormalForm& GetSolver(int index) const; // копия формулы решателя (с моделью победителя)
+};
+
+Portfolio::Portfolio(const ConjunctiveNormalForm &cnf, int threadsCount, bool bitParallel) {
+    if (threadsCount <= 0)
+        throw std::string("Portfolio: threads count must be positive");
+
+    solvers.reserve(threadsCount);
+
+    for (int i = 0; i < threadsCount; i++) {
+        configurations.push_back(GetPortfolioConfiguration(i));
+        configurations.back().bitParallel = configurations.back().bitParallel && bitParallel;
+        solvers.push_back(cnf); // каждому потоку своя копия, общего изменяемого состояния нет
+        solvers.back().SetProofWriter(nullptr); // один файл доказательства нельзя писать из нескольких потоков
+    }
+
+    verdict = Verdict::Unknown;
+}
+
+// работа одного потока
+void Portfolio::Run(int index) {
+    const PortfolioConfiguration &configuration = configurations[index];
+    ConjunctiveNormalForm &solver = solvers[index];
+
+    solver.SetRestartPolicy(configuration.restartPolicy);
+    solver.SetPhaseSaving(configuration.phaseSaving);
+    solver.SetBitParallel(configuration.bitParallel);
+    solver.SetSeed(configuration.seed);
+    solver.SetInterruptFlag(&stop);
+
+    Verdict result = configuration.useCDCL ? solver.CDCL(configuration.strategy) : solver.DPLL(configuration.strategy);
+
+    if (result == Verdict::Unknown) // остановлен победителем или исчерпал ограничения
+        return;
+
+    int expected = -1;
+
+    if (winner.compare_exchange_strong(expected, index)) { // ответ записывает только первый
+        verdict = result;
+        stop.store(true);
+    }
+}
+
+// запуск всех решателей, возвращает ответ первого завершившегося (UNKNOWN, если все исчерпали ограничения)
+Verdict Portfolio::Solve() {
+    stop.store(false);
+    winner.store(-1);
+    verdict = Verdict::Unknown;
+
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < solvers.size(); i++)
+        threads.emplace_back(&Portfolio::Run, this, i);
+
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    return verdict;
+}
+
+// номер победившего решателя
+int Portfolio::GetWinner() const {
+    return winner.load();
+}
+
+// настройки решателя
+const PortfolioConfiguration& Portfolio::GetConfiguration(int index) const {
+    return configurations[index];
+}
+
+// копия формулы решателя (с моделью победителя)
+const ConjunctiveNormalForm& Portfolio::GetSolver(int index) const {
+    return solvers[index];
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+// запись доказательства невыполнимости в формате DRAT (текстовом или двоичном) через большой буфер
+class ProofWriter {
+    static const size_t BUFFER_SIZE = 1 << 22; // размер буфера записи
+    static const size_t MAX_LITERAL_BYTES = 12; // наибольшая длина записи одного литерала
+
+    int fd; // дескриптор файла доказательства
+    bool binary; // двоичный формат
+    std::vector<char> buffer; // буфер записи
+    size_t used; // занятая часть буфера
+    size_t bytesCount; // число записанных байт
+    long long addedCount; // число добавленных клауз
+    long long deletedCount; // число удалённых клауз
+
+    void Flush(); // сброс буфера в файл
+    void WriteLiteral(int literal); // запись литерала (код 2 * переменная + знак)
+    void WriteClause(char type, const int *clause, int size); // запись строки доказательства
+public:
+    ProofWriter(const std::string &path, bool binary);
+    ~ProofWriter();
+
+    ProofWriter(const ProofWriter&) = delete;
+    ProofWriter& operator=(const ProofWriter&) = delete;
+
+    void AddClause(const int *clause, int size); // выведенная клауза (коды литералов)
+    void AddClause(const std::vector<int> &clause); // выведенная клауза (коды литералов)
+    void DeleteClause(const int *clause, int size); // удалённая клауза (коды литералов)
+    void Close(); // сброс буфера и закрытие файла
+
+    size_t GetBytesCount() const; // число записанных байт
+    long long GetAddedCount() const; // число добавленных клауз
+    long long GetDeletedCount() const; // число удалённых клауз
+};
+
+ProofWriter::ProofWriter(const std::string &path, bool binary) {
+    fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0)
+        throw std::string("unable to create proof file '") + path + "'";
+
+    this->binary = binary;
+    buffer.resize(BUFFER_SIZE);
+    used = 0;
+    bytesCount = 0;
+    addedCount = 0;
+    deletedCount = 0;
+}
+
+ProofWriter::~ProofWriter() {
+    try {
+        Close();
+    }
+    catch (const std::string &) {
+        // ошибку записи из деструктора сообщить некуда, незаписанный хвост теряется
+    }
+}
+
+// сброс буфера в файл
+void ProofWriter::Flush() {
+    size_t written = 0;
+
+    while (written < used) {
+        ssize_t count = write(fd, buffer.data() + written, used - written);
+
+        if (count <= 0)
+            throw std::string("unable to write proof file");
+
+        written += count;
+    }
+
+    bytesCount += used;
+    used = 0;
+}
+
+// запись литерала (код 2 * переменная + знак)
+void ProofWriter::WriteLiteral(int literal) {
+    char *output = buffer.data() + used;
+
+    if (binary) { // двоичный DRAT кодирует литерал тем же числом 2 * переменная + знак, по 7 бит на байт
+        unsigned value = literal;
+
+        while (value > 127) {
+            *output++ = (char) (128 | (value & 127));
+            value >>= 7;
+        }
+
+        *output++ = (char) value;
+    }
+    else {
+        char digits[12];
+        int count = 0;
+        unsigned value = literal >> 1;
+
+        if (literal & 1)
+            *output++ = '-';
+
+        do {
+            digits[count++] = '0' + value % 10;
+            value /= 10;
+        } while (value > 0);
+
+        while (count > 0)
+            *output++ = digits[--count];
+
+        *output++ = ' ';
+    }
+
+    used = output - buffer.data();
+}
+
+// запись строки доказательства
+void ProofWriter::WriteClause(char type, const int *clause, int size) {
+    if (used + (size + 2) * MAX_LITERAL_BYTES > buffer.size()) {
+        Flush();
+
+        if ((size + 2) * MAX_LITERAL_BYTES > buffer.size())
+            buffer.resize((size + 2) * MAX_LITERAL_BYTES); // клауза длиннее буфера
+    }
+
+    if (binary) {
+        buffer[used++] = type;
+    }
+    else if (type == 'd') {
+        buffer[used++] = 'd';
+        buffer[used++] = ' ';
+    }
+
+    for (int i = 0; i < size; i++)
+        WriteLiteral(clause[i]);
+
+    if (binary) {
+        buffer[used++] = 0;
+    }
+    else {
+        buffer[used++] = '0';
+        buffer[used++] = '\n';
+    }
+}
+
+// выведенная клауза (коды литералов)
+void ProofWriter::AddClause(const int *clause, int size) {
+    WriteClause('a', clause, size);
+    addedCount++;
+}
+
+// выведенная клауза (коды литералов)
+void ProofWriter::AddClause(const std::vector<int> &clause) {
+    AddClause(clause.data(), clause.size());
+}
+
+// удалённая клауза (коды литералов)
+void ProofWriter::DeleteClause(const int *clause, int size) {
+    WriteClause('d', clause, size);
+    deletedCount++;
+}
+
+// сброс буфера и закрытие файла
+void ProofWriter::Close() {
+    if (fd < 0)
+        return;
+
+    Flush();
+    close(fd);
+    fd = -1;
+}
+
+// число записанных байт
+size_t ProofWriter::GetBytesCount() const {
+    return bytesCount + used;
+}
+
+// число добавленных клауз
+long long ProofWriter::GetAddedCount() const {
+    return addedCount;
+}
+
+// число удалённых клауз
+long long ProofWriter::GetDeletedCount() const {
+    return deletedCount;
+}
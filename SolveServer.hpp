@@ -0,0 +1,389 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "ConjunctiveNormalForm.hpp"
+#include "BatchRunner.hpp"
+
+// формула, прочитанная сервером из потока задач
+struct ServerRequest {
+    int index; // номер формулы в потоке
+    std::string tag; // метка из строки "c id <метка>" (пустая - отвечаем номером)
+    std::string text; // текст формулы в формате DIMACS
+};
+
+// сервер решения потока формул: формулы разделяются строкой "%", решаются пулом потоков,
+// результаты пишутся строками "<метка или номер> <ответ> [модель]" в порядке формул или по готовности
+class SolveServer {
+    BatchConfiguration configuration; // настройки решения
+    int threadsCount; // число потоков решения
+    bool ordered; // писать ли результаты в порядке формул
+    size_t capacity; // наибольшее число прочитанных, но не решённых формул
+
+    std::vector<std::unique_ptr<ConjunctiveNormalForm>> solvers; // формулы потоков решения (перечитываются через Reload)
+    std::deque<ServerRequest> requests; // прочитанные формулы
+    std::vector<std::string> freeBuffers; // освободившиеся буферы текстов формул
+    std::mutex mutex; // защита очереди, буферов и итогов
+    std::condition_variable notEmpty; // в очереди появилась формула или поток задач закончился
+    std::condition_variable notFull; // в очереди освободилось место
+    bool inputClosed; // прочитаны ли все формулы потока
+    BatchSummary summary; // итоги текущего потока задач
+
+    int inputFd; // дескриптор потока задач
+    std::vector<char> inputBuffer; // блок потока задач
+    size_t inputPosition; // первый неразобранный байт блока
+    size_t inputEnd; // конец данных блока
+
+    int outputFd; // дескриптор для результатов
+    bool outputFailed; // перестал ли принимать результаты получатель
+    std::map<int, std::string> finished; // готовые результаты, ожидающие предыдущих (ordered)
+    int nextOutput; // номер следующего результата для вывода
+    std::mutex outputMutex; // защита вывода
+
+    bool ReadLine(std::string &text); // дописывание следующей строки потока в text без перевода строки (false в конце потока)
+    bool ReadRequest(ServerRequest &request); // чтение следующей формулы (false, если формул больше нет)
+    void Work(int worker); // работа потока решения
+    void WriteAll(const std::string &data); // запись всех байт в дескриптор результатов
+    void WriteResult(int index, std::string &result); // вывод результата сразу или после предыдущих
+public:
+    SolveServer(const BatchConfiguration &configuration, int threadsCount, bool ordered = true);
+
+    BatchSummary Serve(int inputFd, int outputFd); // решение всех формул потока задач
+    void Listen(const std::string &socketPath); // приём соединений по Unix-сокету, формулы и результаты идут по соединению
+};
+
+SolveServer::SolveServer(const BatchConfiguration &configuration, int threadsCount, bool ordered) {
+    if (threadsCount <= 0)
+        throw std::string("SolveServer: threads count must be positive");
+
+    this->configuration = configuration;
+    this->threadsCount = threadsCount;
+    this->ordered = ordered;
+
+    capacity = 2 * threadsCount;
+    solvers.resize(threadsCount);
+    inputBuffer.resize(1 << 16);
+}
+
+// дописывание следующей строки потока в text без перевода строки (false в конце потока)
+bool SolveServer::ReadLine(std::string &text) {
+    size_t start = text.size();
+
+    while (true) {
+        if (inputPosition == inputEnd) {
+            ssize_t count = read(inputFd, inputBuffer.data(), inputBuffer.size());
+
+            if (count < 0 && errno == EINTR)
+                continue;
+
+            if (count <= 0)
+                return text.size() > start; // последняя строка без перевода строки
+
+            inputPosition = 0;
+            inputEnd = count;
+        }
+
+        const char *first = inputBuffer.data() + inputPosition;
+        const char *newline = (const char *) std::memchr(first, '\n', inputEnd - inputPosition);
+        const char *last = newline ? newline : inputBuffer.data() + inputEnd;
+
+        text.append(first, last);
+        inputPosition = last - inputBuffer.data() + (newline != nullptr);
+
+        if (newline)
+            return true;
+    }
+}
+
+// чтение следующей формулы (false, если формул больше нет)
+bool SolveServer::ReadRequest(ServerRequest &request) {
+    request.tag.clear();
+    request.text.clear();
+
+    size_t start = 0; // начало текущей строки в тексте
+
+    while (ReadLine(request.text)) {
+        size_t end = request.text.size();
+
+        while (end > start && (request.text[end - 1] == '\r' || request.text[end - 1] == ' ' || request.text[end - 1] == '\t'))
+            end--;
+
+        if (end == start + 1 && request.text[start] == '%') { // разделитель формул
+            request.text.resize(start);
+
+            if (start > 0)
+                return true;
+
+            continue;
+        }
+
+        // до начала формулы пропускаем пустые строки и служебный 0 после '%' в файлах SATLIB
+        if (start == 0 && (end == 0 || (request.text[0] != 'c' && request.text[0] != 'p'))) {
+            request.text.clear();
+            continue;
+        }
+
+        if (request.text.compare(start, 5, "c id ") == 0)
+            request.tag.assign(request.text, start + 5, end - start - 5);
+
+        request.text += '\n';
+        start = request.text.size();
+    }
+
+    return start > 0; // последняя формула без разделителя
+}
+
+// работа потока решения
+void SolveServer::Work(int worker) {
+    std::unique_ptr<ConjunctiveNormalForm> &cnf = solvers[worker];
+    std::string result; // строка результата (память переиспользуется между формулами)
+    ServerRequest request;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (requests.empty() && !inputClosed)
+                notEmpty.wait(lock);
+
+            if (requests.empty())
+                return;
+
+            request = std::move(requests.front());
+            requests.pop_front();
+            notFull.notify_one();
+        }
+
+        std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+        std::string error;
+
+        try {
+            DimacsReader reader(request.text.data(), request.text.size());
+
+            if (cnf)
+                cnf->Reload(reader, configuration.removeDuplicates, configuration.subsumption, configuration.elimination, configuration.probing);
+            else
+                cnf.reset(new ConjunctiveNormalForm(reader, configuration.removeDuplicates, configuration.subsumption, configuration.elimination, configuration.probing));
+        }
+        catch (const std::string &exception) {
+            error = exception;
+        }
+
+        std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+        double parseTime = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() / 1000.0;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            freeBuffers.push_back(std::move(request.text)); // текст разобран, буфер возвращается читателю
+        }
+
+        result = request.tag.empty() ? std::to_string(request.index) : request.tag;
+        Verdict verdict = Verdict::Unknown;
+        double solveTime = 0;
+
+        if (error.empty()) {
+            verdict = SolveWithConfiguration(*cnf, configuration);
+            solveTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - t1).count() / 1000.0;
+            result += ' ';
+            result += VerdictToString(verdict);
+
+            if (verdict == Verdict::Sat) {
+                for (int i = 1; i <= cnf->GetVariablesCount(); i++) {
+                    result += ' ';
+                    result += std::to_string(cnf->GetTermValue(i) == TermValue::True ? i : -i);
+                }
+
+                result += " 0";
+            }
+            else if (verdict == Verdict::Unknown) {
+                result += ' ';
+                result += StopReasonToString(cnf->GetStopReason());
+            }
+        }
+        else {
+            result += " ERROR ";
+            result += error;
+        }
+
+        result += '\n';
+        WriteResult(request.index, result);
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!error.empty())
+            summary.errors++;
+        else
+            (verdict == Verdict::Sat ? summary.sat : verdict == Verdict::Unsat ? summary.unsat : summary.unknown)++;
+
+        summary.parseTime += parseTime;
+        summary.solveTime += solveTime;
+    }
+}
+
+// запись всех байт в дескриптор результатов
+void SolveServer::WriteAll(const std::string &data) {
+    size_t written = 0;
+
+    while (!outputFailed && written < data.size()) {
+        ssize_t count = write(outputFd, data.data() + written, data.size() - written);
+
+        if (count < 0 && errno == EINTR)
+            continue;
+
+        if (count <= 0)
+            outputFailed = true; // получатель закрыл соединение, формулы дорешиваются без вывода
+        else
+            written += count;
+    }
+}
+
+// вывод результата сразу или после предыдущих
+void SolveServer::WriteResult(int index, std::string &result) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+
+    if (!ordered) {
+        WriteAll(result);
+        return;
+    }
+
+    if (index != nextOutput) {
+        finished[index].swap(result); // поток решения получает взамен пустую строку
+        return;
+    }
+
+    WriteAll(result);
+    nextOutput++;
+
+    for (auto it = finished.begin(); it != finished.end() && it->first == nextOutput; it = finished.erase(it)) {
+        WriteAll(it->second);
+        nextOutput++;
+    }
+}
+
+// решение всех формул потока задач
+BatchSummary SolveServer::Serve(int inputFd, int outputFd) {
+    this->inputFd = inputFd;
+    this->outputFd = outputFd;
+    inputPosition = inputEnd = 0;
+    outputFailed = false;
+    finished.clear();
+    nextOutput = 0;
+    requests.clear();
+    inputClosed = false;
+    summary = { 0, 0, 0, 0, 0, 0, 0 };
+
+    signal(SIGPIPE, SIG_IGN); // закрытый получатель (соединение или стандартный вывод) - ошибка записи, а не завершение процесса
+
+    std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < threadsCount; i++)
+        threads.emplace_back(&SolveServer::Work, this, i);
+
+    // текущий поток читает формулы, пока потоки решения их разбирают
+    for (int index = 0; ; index++) {
+        ServerRequest request;
+        request.index = index;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (!freeBuffers.empty()) {
+                request.text.swap(freeBuffers.back());
+                freeBuffers.pop_back();
+            }
+        }
+
+        if (!ReadRequest(request))
+            break;
+
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (requests.size() >= capacity)
+            notFull.wait(lock);
+
+        requests.push_back(std::move(request));
+        notEmpty.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        inputClosed = true;
+        notEmpty.notify_all(); // больше формул не будет
+    }
+
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    summary.wallTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - t0).count() / 1000.0;
+    return summary;
+}
+
+// приём соединений по Unix-сокету, формулы и результаты идут по соединению
+void SolveServer::Listen(const std::string &socketPath) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (socketPath.size() >= sizeof(address.sun_path))
+        throw std::string("socket path is too long '") + socketPath + "'";
+
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    struct stat status;
+
+    // удаляется только сокет, оставшийся от прошлого запуска, любой другой файл остаётся нетронутым
+    if (lstat(socketPath.c_str(), &status) == 0) {
+        if (S_ISREG(status.st_mode))
+            throw std::string("'") + socketPath + "' is a regular file: server mode reads formulas from '-' (standard input) or listens on a Unix socket path";
+
+        if (!S_ISSOCK(status.st_mode))
+            throw std::string("'") + socketPath + "' exists and is not a socket";
+
+        if (unlink(socketPath.c_str()) < 0)
+            throw std::string("unable to remove old socket '") + socketPath + "'";
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listener < 0)
+        throw std::string("unable to create socket");
+
+    if (bind(listener, (sockaddr *) &address, sizeof(address)) < 0 || listen(listener, 16) < 0) {
+        close(listener);
+        throw std::string("unable to listen on socket '") + socketPath + "'";
+    }
+
+    // соединения обслуживаются по очереди, формулы одного соединения решаются параллельно
+    while (true) {
+        int connection = accept(listener, nullptr, nullptr);
+
+        if (connection < 0) {
+            if (errno == EINTR)
+                continue;
+
+            close(listener);
+            throw std::string("unable to accept connection on '") + socketPath + "'";
+        }
+
+        BatchSummary summary = Serve(connection, connection);
+        close(connection);
+
+        std::cerr << "Connection closed: " << summary.sat + summary.unsat << " solved (" << summary.sat << " SAT, " << summary.unsat << " UNSAT, " << summary.unknown << " UNKNOWN, " << summary.errors << " errors) in " << summary.wallTime << " ms" << std::endl;
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <vector>
+
+// двоичная куча переменных по убыванию активности с индексами позиций
+class VariableHeap {
+    std::vector<int> heap; // переменные в порядке кучи
+    std::vector<int> positions; // позиции переменных в куче (-1, если переменной нет)
+    std::vector<double> activity; // активности переменных
+
+    bool IsBetter(int variable1, int variable2) const; // должна ли первая переменная стоять выше второй
+    void SiftUp(int position); // подъём элемента
+    void SiftDown(int position); // спуск элемента
+public:
+    VariableHeap(int variablesCount = 0);
+
+    void Reset(int variablesCount); // пустая куча с нулевыми активностями без освобождения памяти
+    bool Empty() const; // пуста ли куча
+    bool Contains(int variable) const; // есть ли переменная в куче
+    double GetActivity(int variable) const; // активность переменной
+
+    void Insert(int variable); // добавление переменной
+    int Pop(); // извлечение переменной с наибольшей активностью
+    void Bump(int variable, double increment); // увеличение активности переменной
+    void Scale(double factor); // масштабирование всех активностей
+    void Grow(int variablesCount); // расширение под большее число переменных (новые переменные не добавляются в кучу)
+};
+
+VariableHeap::VariableHeap(int variablesCount) {
+    Reset(variablesCount);
+}
+
+// пустая куча с нулевыми активностями без освобождения памяти
+void VariableHeap::Reset(int variablesCount) {
+    heap.clear();
+    positions.assign(variablesCount + 1, -1);
+    activity.assign(variablesCount + 1, 0);
+    heap.reserve(variablesCount);
+}
+
+// должна ли первая переменная стоять выше второй
+bool VariableHeap::IsBetter(int variable1, int variable2) const {
+    if (activity[variable1] != activity[variable2])
+        return activity[variable1] > activity[variable2];
+
+    return variable1 < variable2; // при равенстве выбираем меньший индекс
+}
+
+// подъём элемента
+void VariableHeap::SiftUp(int position) {
+    int variable = heap[position];
+
+    while (position > 0) {
+        int parent = (position - 1) / 2;
+
+        if (!IsBetter(variable, heap[parent]))
+            break;
+
+        heap[position] = heap[parent];
+        positions[heap[position]] = position;
+        position = parent;
+    }
+
+    heap[position] = variable;
+    positions[variable] = position;
+}
+
+// спуск элемента
+void VariableHeap::SiftDown(int position) {
+    int variable = heap[position];
+    int size = heap.size();
+
+    while (2 * position + 1 < size) {
+        int child = 2 * position + 1;
+
+        if (child + 1 < size && IsBetter(heap[child + 1], heap[child]))
+            child++;
+
+        if (!IsBetter(heap[child], variable))
+            break;
+
+        heap[position] = heap[child];
+        positions[heap[position]] = position;
+        position = child;
+    }
+
+    heap[position] = variable;
+    positions[variable] = position;
+}
+
+// пуста ли куча
+bool VariableHeap::Empty() const {
+    return heap.empty();
+}
+
+// есть ли переменная в куче
+bool VariableHeap::Contains(int variable) const {
+    return positions[variable] >= 0;
+}
+
+// активность переменной
+double VariableHeap::GetActivity(int variable) const {
+    return activity[variable];
+}
+
+// добавление переменной
+void VariableHeap::Insert(int variable) {
+    if (Contains(variable))
+        return;
+
+    heap.push_back(variable);
+    SiftUp(heap.size() - 1);
+}
+
+// извлечение переменной с наибольшей активностью
+int VariableHeap::Pop() {
+    int top = heap[0];
+    positions[top] = -1;
+
+    int last = heap.back();
+    heap.pop_back();
+
+    if (!heap.empty()) {
+        heap[0] = last;
+        SiftDown(0);
+    }
+
+    return top;
+}
+
+// увеличение активности переменной
+void VariableHeap::Bump(int variable, double increment) {
+    activity[variable] += increment;
+
+    if (Contains(variable))
+        SiftUp(positions[variable]);
+}
+
+// масштабирование всех активностей (порядок кучи не меняется)
+void VariableHeap::Scale(double factor) {
+    for (size_t i = 0; i < activity.size(); i++)
+        activity[i] *= factor;
+}
+
+// расширение под большее число переменных (новые переменные не добавляются в кучу)
+void VariableHeap::Grow(int variablesCount) {
+    positions.resize(variablesCount + 1, -1);
+    activity.resize(variablesCount + 1, 0);
+}
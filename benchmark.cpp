@@ -0,0 +1,542 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <stdexcept>
+#include "ConjunctiveNormalForm.hpp"
+#include "BatchRunner.hpp"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Time;
+typedef std::chrono::time_point<Time> TimePoint;
+typedef std::chrono::nanoseconds ns;
+
+// набор формул с известным ответом
+struct Task {
+    string name; // имя в таблице
+    string path; // каталог или файл
+    bool isSat; // ожидаемый ответ
+};
+
+// один запуск на одном файле
+struct Sample {
+    double parseTime; // время чтения (мкс)
+    double solveTime; // время решения (мкс)
+    long long decisions; // число разветвлений
+    long long propagations; // число присваиваний при распространении
+    long long conflicts; // число конфликтов
+    bool solved; // получен ли ответ до ограничений
+};
+
+// характеристики выборки
+struct Distribution {
+    double mean; // среднее
+    double median; // медиана
+    double p90; // 90-й процентиль
+    double stddev; // стандартное отклонение
+};
+
+// настройки замера
+struct Options {
+    int warmup; // число прогревочных проходов по набору
+    int repeats; // число измеряемых проходов по набору
+    bool removeDuplicates; // удалять ли дубликаты при чтении
+    bool subsumption; // удалять ли включающие клаузы
+    bool bitParallel; // решать ли DPLL небольших формул битовым движком
+    bool printTable; // печатать ли таблицу для README вместо подробного отчёта
+    bool incremental; // проверять ли инкрементальный интерфейс вместо замера
+    SearchLimits limits; // ограничения одного решения
+};
+
+// время между отметками в микросекундах (с дробной частью)
+double Microseconds(const TimePoint &t0, const TimePoint &t1) {
+    return std::chrono::duration_cast<ns>(t1 - t0).count() / 1000.0;
+}
+
+// характеристики выборки (values сортируется)
+Distribution GetDistribution(vector<double> &values) {
+    Distribution distribution = { 0, 0, 0, 0 };
+
+    if (values.empty())
+        return distribution;
+
+    sort(values.begin(), values.end());
+
+    for (size_t i = 0; i < values.size(); i++)
+        distribution.mean += values[i];
+
+    distribution.mean /= values.size();
+
+    for (size_t i = 0; i < values.size(); i++)
+        distribution.stddev += (values[i] - distribution.mean) * (values[i] - distribution.mean);
+
+    distribution.stddev = sqrt(distribution.stddev / values.size());
+
+    size_t middle = values.size() / 2;
+    distribution.median = values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+    distribution.p90 = values[min(values.size() - 1, (size_t) ceil(0.9 * values.size()) - 1)];
+
+    return distribution;
+}
+
+// решение одного файла с проверкой ответа (проверка не зависит от NDEBUG)
+Sample SolveFile(const string &path, bool isSat, DecisionStrategy strategy, bool useCDCL, const Options &options) {
+    Sample sample;
+
+    TimePoint t0 = Time::now();
+    ConjunctiveNormalForm cnf(path, options.removeDuplicates, options.subsumption);
+    cnf.SetBitParallel(options.bitParallel);
+    cnf.SetLimits(options.limits);
+    TimePoint t1 = Time::now();
+    Verdict verdict = useCDCL ? cnf.CDCL(strategy) : cnf.DPLL(strategy);
+    TimePoint t2 = Time::now();
+
+    sample.solved = verdict != Verdict::Unknown; // остановка по ограничениям - не ошибка, а неизвестное время
+
+    if (sample.solved && verdict != (isSat ? Verdict::Sat : Verdict::Unsat))
+        throw string("wrong verdict ") + VerdictToString(verdict) + " for '" + path + "' with " + StrategyToString(strategy) + (useCDCL ? " CDCL" : " DPLL");
+
+    const SolverStatistics &statistics = cnf.GetSolverStatistics();
+
+    sample.parseTime = Microseconds(t0, t1);
+    sample.solveTime = Microseconds(t1, t2);
+    sample.decisions = statistics.decisions;
+    sample.propagations = statistics.propagations;
+    sample.conflicts = statistics.conflicts;
+
+    return sample;
+}
+
+// прогрев и измеряемые проходы по всем файлам набора
+vector<Sample> RunTask(const Task &task, const vector<string> &files, DecisionStrategy strategy, bool useCDCL, const Options &options) {
+    vector<Sample> samples;
+
+    for (int run = 0; run < options.warmup + options.repeats; run++) {
+        for (size_t i = 0; i < files.size(); i++) {
+            Sample sample = SolveFile(files[i], task.isSat, strategy, useCDCL, options);
+
+            if (!sample.solved) // остальные запуски тоже упрутся в ограничения
+                return { sample };
+
+            if (run >= options.warmup)
+                samples.push_back(sample);
+        }
+    }
+
+    return samples;
+}
+
+// клаузы файла без предобработки (для проверки моделей независимо от решателя)
+vector<vector<int>> ReadClauses(const string &path) {
+    DimacsReader reader(path);
+    vector<vector<int>> clauses;
+    vector<int> clause;
+    int literal;
+
+    while (true) {
+        reader.SkipSpaces();
+        int symbol = reader.Peek();
+
+        if (symbol == EOF || symbol == '%')
+            break;
+
+        if (symbol == 'c' || symbol == 'p') {
+            reader.SkipLine();
+            continue;
+        }
+
+        if (!reader.ReadInt(literal))
+            throw string("Invalid file '") + path + "'";
+
+        if (literal != 0) {
+            clause.push_back(literal);
+        }
+        else if (!clause.empty()) {
+            clauses.push_back(clause);
+            clause.clear();
+        }
+    }
+
+    if (!clause.empty())
+        clauses.push_back(clause);
+
+    return clauses;
+}
+
+// выполнены ли все клаузы и предположения на модели решателя
+bool IsModel(const ConjunctiveNormalForm &cnf, const vector<vector<int>> &clauses, const vector<int> &assumptions) {
+    auto isTrue = [&cnf](int literal) {
+        return (cnf.GetTermValue(abs(literal)) == TermValue::True) == (literal > 0);
+    };
+
+    for (size_t i = 0; i < clauses.size(); i++)
+        if (none_of(clauses[i].begin(), clauses[i].end(), isTrue))
+            return false;
+
+    return all_of(assumptions.begin(), assumptions.end(), isTrue);
+}
+
+// проверка инкрементальных вызовов на одном файле: модели, ядро из предположений и его противоречивость
+void CheckIncremental(const string &path, int calls, mt19937 &generator, vector<long long> &counts) {
+    ConjunctiveNormalForm cnf(path);
+    ConjunctiveNormalForm original = cnf; // копия без выученных клауз, на ней проверяются ядра
+    vector<vector<int>> clauses = ReadClauses(path);
+    size_t originalCount = clauses.size();
+    uniform_int_distribution<int> variables(1, cnf.GetVariablesCount());
+
+    auto randomLiteral = [&]() {
+        return generator() % 2 ? variables(generator) : -variables(generator);
+    };
+
+    for (int call = 0; call < calls; call++) {
+        string where = " for '" + path + "' at call " + to_string(call + 1);
+
+        if (call % 4 == 3) { // каждый четвёртый вызов сначала добавляет случайную клаузу
+            vector<int> clause = { randomLiteral(), randomLiteral(), randomLiteral() };
+            cnf.AddClause(clause);
+            clauses.push_back(clause);
+        }
+
+        vector<int> assumptions(1 + generator() % 6); // повторы и противоположные литералы тоже допустимы
+
+        for (size_t i = 0; i < assumptions.size(); i++)
+            assumptions[i] = randomLiteral();
+
+        Verdict verdict = cnf.Solve(assumptions);
+
+        if (verdict == Verdict::Sat) {
+            if (!IsModel(cnf, clauses, assumptions))
+                throw string("wrong model") + where;
+
+            counts[0]++;
+            continue;
+        }
+
+        if (verdict != Verdict::Unsat)
+            throw string("wrong verdict ") + VerdictToString(verdict) + where;
+
+        const vector<int> &core = cnf.GetFailedAssumptions();
+        ConjunctiveNormalForm check = original;
+
+        for (size_t i = originalCount; i < clauses.size(); i++)
+            check.AddClause(clauses[i]);
+
+        for (size_t i = 0; i < core.size(); i++) {
+            if (find(assumptions.begin(), assumptions.end(), core[i]) == assumptions.end())
+                throw string("failed assumption ") + to_string(core[i]) + " is not an assumption" + where;
+
+            check.AddClause({ core[i] });
+        }
+
+        if (check.DPLL(DecisionStrategy::Moms) != Verdict::Unsat)
+            throw string("failed assumptions are satisfiable") + where;
+
+        counts[1]++;
+        counts[2] += core.size();
+    }
+}
+
+// подробный отчёт по выборке
+void PrintReport(const Task &task, DecisionStrategy strategy, bool useCDCL, vector<Sample> &samples) {
+    cout << setw(14) << task.name << " " << setw(5) << (useCDCL ? "CDCL" : "DPLL") << " " << setw(8) << StrategyToString(strategy);
+
+    if (!samples[0].solved) {
+        cout << " | ? (stopped by limits)" << endl;
+        return;
+    }
+
+    vector<double> parseTimes;
+    vector<double> solveTimes;
+    double decisions = 0;
+    double propagations = 0;
+    double conflicts = 0;
+
+    for (size_t i = 0; i < samples.size(); i++) {
+        parseTimes.push_back(samples[i].parseTime);
+        solveTimes.push_back(samples[i].solveTime);
+        decisions += samples[i].decisions;
+        propagations += samples[i].propagations;
+        conflicts += samples[i].conflicts;
+    }
+
+    Distribution parse = GetDistribution(parseTimes);
+    Distribution solve = GetDistribution(solveTimes);
+
+    cout << fixed << setprecision(1);
+    cout << " | " << setw(9) << parse.median << " " << setw(9) << parse.p90;
+    cout << " | " << setw(11) << solve.mean << " " << setw(11) << solve.median << " " << setw(11) << solve.p90 << " " << setw(11) << solve.stddev;
+    cout << " | " << setw(11) << decisions / samples.size() << " " << setw(13) << propagations / samples.size() << " " << setw(11) << conflicts / samples.size() << endl;
+    cout.unsetf(ios::floatfield);
+}
+
+// заголовок подробного отчёта
+void PrintReportHeader(int filesRuns) {
+    cout << "Times in microseconds per file, counters are averaged per file, " << filesRuns << " measured runs over every set" << endl;
+    cout << setw(14) << "cnf" << " " << setw(5) << "alg" << " " << setw(8) << "strategy";
+    cout << " | " << setw(9) << "parse med" << " " << setw(9) << "parse p90";
+    cout << " | " << setw(11) << "solve mean" << " " << setw(11) << "solve med" << " " << setw(11) << "solve p90" << " " << setw(11) << "solve std";
+    cout << " | " << setw(11) << "decisions" << " " << setw(13) << "propagations" << " " << setw(11) << "conflicts" << endl;
+}
+
+// строка таблицы для README: среднее время решения в мс, лучшее выделено, остановленные ограничениями - ?
+void PrintTableRow(const Task &task, const vector<double> &times) {
+    size_t best = times.size();
+
+    for (size_t i = 0; i < times.size(); i++)
+        if (times[i] >= 0 && (best == times.size() || times[i] < times[best]))
+            best = i;
+
+    cout << "| " << setw(14) << task.name << " |";
+
+    for (size_t i = 0; i < times.size(); i++) {
+        ostringstream value;
+
+        if (times[i] < 0)
+            value << "?";
+        else if (times[i] >= 1e6) // от секунды - целые миллисекунды без экспоненты
+            value << fixed << setprecision(0) << times[i] / 1000;
+        else
+            value << setprecision(3) << times[i] / 1000;
+
+        cout << " " << setw(9) << (i == best ? "**" + value.str() + "**" : value.str()) << " |";
+    }
+
+    cout << endl;
+}
+
+// заголовок таблицы для README
+void PrintTableHeader(const vector<DecisionStrategy> &strategies, bool useCDCL) {
+    cout << "## Performance of " << (useCDCL ? "CDCL" : "DPLL") << " SAT solver (mean solve time in ms)" << endl;
+    cout << "| cnf \\ strategy |";
+
+    for (size_t i = 0; i < strategies.size(); i++)
+        cout << " " << setw(9) << StrategyToString(strategies[i]) << " |";
+
+    cout << endl << "|       :-:      |";
+
+    for (size_t i = 0; i < strategies.size(); i++)
+        cout << "       :-: |";
+
+    cout << endl;
+}
+
+// разбор неотрицательного целого значения флага
+long long ParseCount(const string &flag, const string &value) {
+    size_t length = 0;
+    long long result = -1;
+
+    try {
+        result = stoll(value, &length);
+    }
+    catch (const logic_error &) { // не число или вне диапазона
+        length = 0;
+    }
+
+    if (length == 0 || length != value.size() || result < 0 || result > INT_MAX)
+        throw string("Invalid value '") + value + "' of " + flag;
+
+    return result;
+}
+
+// разбор неотрицательного дробного значения флага
+double ParseAmount(const string &flag, const string &value) {
+    size_t length = 0;
+    double result = -1;
+
+    try {
+        result = stod(value, &length);
+    }
+    catch (const logic_error &) {
+        length = 0;
+    }
+
+    if (length == 0 || length != value.size() || !(result >= 0) || std::isinf(result))
+        throw string("Invalid value '") + value + "' of " + flag;
+
+    return result;
+}
+
+void Help() {
+    cout << "Usage: ./benchmark [-w warmup] [-n repeats] [-a dpll|cdcl|both] [-d] [-s] [-simd] [-time seconds] [-conflicts count] [-table] [-incremental] [cnf names...]" << endl;
+    cout << "  -w     - unmeasured runs over every set before measuring (1 for default)" << endl;
+    cout << "  -n     - measured runs over every set (3 for default)" << endl;
+    cout << "  -a     - algorithms to measure (both for default)" << endl;
+    cout << "  -d, -s - remove duplicates, use subsumption while reading" << endl;
+    cout << "  -simd  - solve DPLL of formulas with at most 256 variables by the bit-parallel engine (off for default: it ignores the strategy)" << endl;
+    cout << "  -time  - time limit of one solve in seconds, 0 for no limit (60 for default)" << endl;
+    cout << "  -conflicts - conflicts limit of one solve, 0 for no limit (0 for default)" << endl;
+    cout << "  -table - print markdown tables of mean solve time for README instead of the detailed report, '?' for stopped by limits" << endl;
+    cout << "  -incremental - check models and failed assumptions of incremental Solve with random assumptions and added clauses instead of measuring (sat20, sat50, unsat50 for default, -n calls per file x 8)" << endl;
+    cout << "  names  - sets to measure (sat20, unsat50, pigeon-hole7, hanoi4, ...; all for default)" << endl;
+}
+
+int main(int argc, char **argv) {
+    vector<DecisionStrategy> strategies = {
+        DecisionStrategy::Max,
+        DecisionStrategy::Moms,
+        DecisionStrategy::Weighted,
+        DecisionStrategy::AUPC,
+        DecisionStrategy::Vsids,
+        DecisionStrategy::LookAhead,
+        DecisionStrategy::Up,
+        DecisionStrategy::First,
+        DecisionStrategy::Random
+    };
+
+    vector<Task> allTasks = {
+        { "sat20", "data/sat20", true },
+
+        { "sat50", "data/sat50", true },
+        { "unsat50", "data/unsat50", false },
+
+        { "sat75", "data/sat75", true },
+        { "unsat75", "data/unsat75", false },
+
+        { "sat100", "data/sat100", true },
+        { "unsat100", "data/unsat100", false },
+
+        { "pigeon-hole6", "data/pigeon-hole/hole6.cnf", false },
+        { "pigeon-hole7", "data/pigeon-hole/hole7.cnf", false },
+        { "pigeon-hole8", "data/pigeon-hole/hole8.cnf", false },
+        { "pigeon-hole9", "data/pigeon-hole/hole9.cnf", false },
+        { "hanoi4", "data/hanoi/hanoi4.cnf", true },
+    };
+
+    Options options = { 1, 3, false, false, false, false, false, { 60, 0, 0, 0 } };
+    vector<bool> modes = { false, true };
+    vector<Task> tasks;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+
+            if (arg == "--help") {
+                Help();
+                return 0;
+            }
+            else if (arg == "-w" && i + 1 < argc) {
+                options.warmup = ParseCount(arg, argv[++i]);
+            }
+            else if (arg == "-n" && i + 1 < argc) {
+                options.repeats = ParseCount(arg, argv[++i]);
+            }
+            else if (arg == "-a" && i + 1 < argc) {
+                string algorithm = argv[++i];
+
+                if (algorithm == "dpll")
+                    modes = { false };
+                else if (algorithm == "cdcl")
+                    modes = { true };
+                else if (algorithm != "both")
+                    throw string("Invalid algorithm '") + algorithm + "'";
+            }
+            else if (arg == "-d") {
+                options.removeDuplicates = true;
+            }
+            else if (arg == "-s") {
+                options.subsumption = true;
+            }
+            else if (arg == "-simd") {
+                options.bitParallel = true;
+            }
+            else if (arg == "-time" && i + 1 < argc) {
+                options.limits.time = ParseAmount(arg, argv[++i]);
+            }
+            else if (arg == "-conflicts" && i + 1 < argc) {
+                options.limits.conflicts = ParseCount(arg, argv[++i]);
+            }
+            else if (arg == "-table") {
+                options.printTable = true;
+            }
+            else if (arg == "-incremental") {
+                options.incremental = true;
+            }
+            else {
+                size_t j = 0;
+
+                while (j < allTasks.size() && allTasks[j].name != arg)
+                    j++;
+
+                if (j == allTasks.size())
+                    throw string("Invalid argument '") + arg + "'";
+
+                tasks.push_back(allTasks[j]);
+            }
+        }
+
+        if (options.repeats == 0)
+            throw string("repeats count must be positive");
+
+        if (tasks.empty())
+            tasks = options.incremental ? vector<Task>(allTasks.begin(), allTasks.begin() + 3) : allTasks;
+
+        if (options.incremental) {
+            mt19937 generator(1); // одинаковые вызовы при каждом запуске
+            int calls = 8 * options.repeats;
+
+            for (size_t i = 0; i < tasks.size(); i++) {
+                vector<string> files = GetBatchFiles(tasks[i].path);
+                vector<long long> counts = { 0, 0, 0 }; // SAT, UNSAT, сумма размеров ядер
+
+                for (size_t j = 0; j < files.size(); j++)
+                    CheckIncremental(files[j], calls, generator, counts);
+
+                cout << setw(14) << tasks[i].name << ": " << files.size() << " files, " << counts[0] + counts[1] << " calls checked (" << counts[0] << " SAT, " << counts[1] << " UNSAT";
+
+                if (counts[1])
+                    cout << ", mean core size " << setprecision(3) << (double) counts[2] / counts[1];
+
+                cout << ")" << endl;
+            }
+
+            return 0;
+        }
+
+        vector<vector<string>> files;
+
+        for (size_t i = 0; i < tasks.size(); i++)
+            files.push_back(GetBatchFiles(tasks[i].path)); // каталог - все *.cnf, файл - он сам
+
+        for (size_t mode = 0; mode < modes.size(); mode++) {
+            bool useCDCL = modes[mode];
+
+            if (options.printTable)
+                PrintTableHeader(strategies, useCDCL);
+            else
+                PrintReportHeader(options.repeats);
+
+            for (size_t i = 0; i < tasks.size(); i++) {
+                vector<double> times;
+
+                for (size_t j = 0; j < strategies.size(); j++) {
+                    vector<Sample> samples = RunTask(tasks[i], files[i], strategies[j], useCDCL, options);
+                    double mean = 0;
+
+                    for (size_t k = 0; k < samples.size(); k++)
+                        mean += samples[k].solveTime / samples.size();
+
+                    times.push_back(samples[0].solved ? mean : -1);
+
+                    if (!options.printTable)
+                        PrintReport(tasks[i], strategies[j], useCDCL, samples);
+                }
+
+                if (options.printTable)
+                    PrintTableRow(tasks[i], times);
+            }
+
+            cout << endl;
+        }
+    }
+    catch (const string &error) {
+        cout << "Error: " << error << endl;
+        return 1;
+    }
+}
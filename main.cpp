@@ -2,19 +2,76 @@
 #include <fstream>
 #include <string>
 #include <chrono>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <csignal>
+#include <climits>
+#include <cmath>
+#include <stdexcept>
 #include "ConjunctiveNormalForm.hpp"
+#include "Portfolio.hpp"
+#include "CubeAndConquer.hpp"
+#include "BatchRunner.hpp"
+#include "SolveServer.hpp"
 
 using namespace std;
 
 typedef std::chrono::high_resolution_clock Time;
 typedef std::chrono::time_point<Time> TimePoint;
 typedef std::chrono::milliseconds ms;
+typedef std::chrono::microseconds us;
+
+std::atomic<bool> interruptRequested(false); // Ctrl+C: остановить поиск и вывести статистику
+
+void HandleInterrupt(int) {
+    interruptRequested.store(true);
+}
+
+// разбор неотрицательного целого значения флага
+long long ParseCount(const string &flag, const string &value) {
+    size_t length = 0;
+    long long result = -1;
+
+    try {
+        result = stoll(value, &length);
+    }
+    catch (const logic_error &) { // не число или вне диапазона
+        length = 0;
+    }
+
+    if (length == 0 || length != value.size() || result < 0)
+        throw string("Invalid value '") + value + "' of " + flag;
+
+    return result;
+}
+
+// разбор неотрицательного дробного значения флага
+double ParseAmount(const string &flag, const string &value) {
+    size_t length = 0;
+    double result = -1;
+
+    try {
+        result = stod(value, &length);
+    }
+    catch (const logic_error &) {
+        length = 0;
+    }
+
+    if (length == 0 || length != value.size() || !(result >= 0) || std::isinf(result))
+        throw string("Invalid value '") + value + "' of " + flag;
+
+    return result;
+}
 
 void Help() {
     cout << "DPLL algorithm." << endl;
     cout << "Developed by Andrew Perminov" << endl << endl;
 
-    cout << "Usage: ./dpll [path/to/cnf/file] [strategy] [-d] [-s]" << endl;
+    cout << "Usage: ./dpll [path/to/cnf/file] [strategy] [cubes|batch|server] [-d] [-s] [-probe] [-e] [-c] [-r policy] [-p] [-nosimd] [-ls algorithm] [-flips count] [-seed value] [-hybrid] [-unordered] [-t threads] [-scaling] [-f format] [-progress conflicts] [-time seconds] [-conflicts count] [-decisions count] [-memory MB] [-proof file] [-binary]" << endl;
+    cout << "Use '-' as path to read cnf from standard input" << endl;
+    cout << "In batch mode path is a directory (all *.cnf files) or a quoted glob pattern" << endl;
+    cout << "In server mode path is '-' for standard input or a Unix socket path to listen on" << endl;
     cout << endl;
     cout << "Decision strategies:" << endl;
     cout << "  first    - get first undefined literal" << endl;
@@ -22,11 +79,56 @@ void Help() {
     cout << "  max      - get literal with max occurencies in clauses" << endl;
     cout << "  moms     - get literal with max occurencies in clauses with minimal size" << endl;
     cout << "  weighted - get literal with max weighted sum (score of l = 2^-|clause with l|)" << endl;
-    cout << "  up       - get literal with max up value (up in unit propagation)" << endl << endl;
+    cout << "  up       - get literal with max up value (up in unit propagation)" << endl;
+    cout << "  aupc     - get literal with max occurencies of clauses by size = 2" << endl;
+    cout << "  vsids    - get literal with max activity in recent conflicts (EVSIDS)" << endl;
+    cout << "  lookahead - propagate both values of candidate variables (max weighted sum), take the variable with max product" << endl;
+    cout << "              of reduced clauses and assert the negation of failed literals" << endl;
+    cout << "  portfolio - run different strategies on several threads, the first verdict wins" << endl << endl;
+
+    cout << "Parallel modes:" << endl;
+    cout << "  portfolio - used instead of strategy, see above" << endl;
+    cout << "  cubes     - split the search space into cubes by the most frequent variables and solve them with DPLL on several threads," << endl;
+    cout << "              idle threads take unsolved cubes or get the unexplored branch of a busy thread" << endl;
+    cout << "  batch     - solve every file of a directory or glob on several threads, one result line per file as soon as it is solved," << endl;
+    cout << "              files are read ahead by separate threads while the others are solved" << endl;
+    cout << "  server    - solve a stream of formulas separated by '%' lines on several threads, one line '<id> <verdict> [model 0]' per formula," << endl;
+    cout << "              id is the tag of a 'c id <tag>' line or the formula number; the process and solvers are reused between formulas" << endl << endl;
+
+    cout << "Restart policies:" << endl;
+    cout << "  none      - never restart (selected by default)" << endl;
+    cout << "  luby      - restart after 100 * luby(i) conflicts" << endl;
+    cout << "  geometric - restart after 100 * 1.5^i conflicts" << endl;
+    cout << "  glucose   - restart when recent learned clauses LBD is worse than average (CDCL only)" << endl << endl;
+
+    cout << "Local search algorithms:" << endl;
+    cout << "  probsat   - flip a variable of a random unsatisfied clause with probability decreasing with its break count (selected by default)" << endl;
+    cout << "  walksat   - flip a variable with zero break count, otherwise a random one with probability 0.567 or one with min break count" << endl << endl;
 
     cout << "Flags:" << endl;
-    cout << "  -d  - remove duplicate clauses during reading (increase time, false for default)" << endl;
-    cout << "  -s  - use subsumption after read (increase time even more, false for default)" << endl;
+    cout << "  -d  - remove duplicate clauses, repeated literals and tautologies during reading (hash based, false for default)" << endl;
+    cout << "  -s  - use subsumption and self-subsuming resolution after read (occurrence lists with clause signatures, false for default)" << endl;
+    cout << "  -probe - after subsumption substitute equivalent literals (SCC of binary implication graph) and fix failed literals (1 s budget)" << endl;
+    cout << "  -e  - use bounded variable elimination after read (resolve away variables while clauses count does not grow, false for default)" << endl;
+    cout << "  -c  - use conflict driven clause learning with backjumping (CDCL) instead of DPLL" << endl;
+    cout << "  -r  - restart policy (none for default)" << endl;
+    cout << "  -p  - use phase saving: decide variable with its last value (false for default)" << endl;
+    cout << "  -nosimd - without a strategy DPLL of formulas with at most 256 variables is solved by the bit-parallel engine (clauses and assignment" << endl;
+    cout << "              as bit masks, clause state by a few AVX2/SSE2 operations, own decision heuristic); the flag disables it, a strategy replaces it" << endl;
+    cout << "  -ls - search a model by stochastic local search instead of DPLL (proves only SAT, stops with UNKNOWN when the flips run out)" << endl;
+    cout << "  -flips - flips budget of local search (1000000 for default, 0 - no limit)" << endl;
+    cout << "  -seed - random seed of local search (1 for default)" << endl;
+    cout << "  -hybrid - solve by DPLL with the chosen strategy when local search runs out of flips" << endl;
+    cout << "  -unordered - write server results as soon as they are solved instead of the input order" << endl;
+    cout << "  -t  - threads count for portfolio and cubes (hardware concurrency for default)" << endl;
+    cout << "  -scaling - solve cubes with 1..threads threads and print speedup" << endl;
+    cout << "  -f  - batch results format: csv or json (one object per line, csv for default)" << endl;
+    cout << "  -progress - print a progress line to standard error every given number of conflicts (off for default)" << endl;
+    cout << "  -time, -conflicts, -decisions, -memory - stop the search with UNKNOWN verdict after the given seconds, conflicts, decisions" << endl;
+    cout << "              or when the clause database exceeds the given megabytes (no limits for default, in cubes mode only time is shared by all cubes)" << endl;
+    cout << "  -proof - write DRAT proof of unsatisfiability to the file (learned, derived and deleted clauses including preprocessing)" << endl;
+    cout << "  -binary - write the proof in binary DRAT format instead of text" << endl;
+    cout << "Ctrl+C stops a single-threaded search with UNKNOWN verdict and prints the statistics" << endl;
 }
 
 int main(int argc, char **argv) {
@@ -40,7 +142,7 @@ int main(int argc, char **argv) {
         return 0;
     }
 
-    if (argc > 5) {
+    if (argc > 30) {
         cout << "Error: invalid arguments count" << endl;
         return -1;
     }
@@ -50,6 +152,29 @@ int main(int argc, char **argv) {
         bool haveStrategy = false; // определена ли стратегия уже
         bool removeDuplicates = false; // удалять ли дублирующиеся клаузы
         bool useSubsumption = false; // удалять ли включающие клаузы
+        bool useProbing = false; // заменять ли эквивалентные литералы и искать ли ложные литералы
+        bool useElimination = false; // исключать ли переменные
+        bool useCDCL = false; // использовать ли обучение на конфликтах
+        RestartPolicy restartPolicy = RestartPolicy::None; // политика перезапусков
+        bool usePhaseSaving = false; // сохранять ли фазы переменных
+        bool useBitParallel = true; // решать ли DPLL небольших формул битовым движком
+        bool useLocalSearch = false; // искать ли модель локальным поиском
+        LocalSearchOptions localSearchOptions = { LocalSearchAlgorithm::ProbSat, 1000000, 1, false }; // настройки локального поиска
+        bool usePortfolio = false; // решать ли несколькими стратегиями параллельно
+        bool useCubes = false; // решать ли кубы параллельно
+        bool printScaling = false; // замерять ли ускорение по числу потоков
+        bool useBatch = false; // решать ли все файлы каталога
+        bool useServer = false; // решать ли поток формул
+        bool serverOrdered = true; // писать ли результаты сервера в порядке формул
+        BatchFormat batchFormat = BatchFormat::Csv; // формат результатов набора файлов
+        long long progressInterval = 0; // число конфликтов между строками прогресса
+        SearchLimits limits = { 0, 0, 0, 0 }; // ограничения поиска
+        string proofPath; // файл доказательства (пустой - без доказательства)
+        bool binaryProof = false; // писать ли доказательство в двоичном формате
+        int threadsCount = std::thread::hardware_concurrency(); // число потоков портфеля
+
+        if (threadsCount <= 0)
+            threadsCount = 4;
 
         for (int i = 2; i < argc; i++) {
             string arg = argv[i];
@@ -60,6 +185,93 @@ int main(int argc, char **argv) {
             else if (arg == "-s") {
                 useSubsumption = true;
             }
+            else if (arg == "-probe") {
+                useProbing = true;
+            }
+            else if (arg == "-e") {
+                useElimination = true;
+            }
+            else if (arg == "-c") {
+                useCDCL = true;
+            }
+            else if (arg == "-r" && i + 1 < argc) {
+                restartPolicy = GetRestartPolicy(argv[++i]);
+            }
+            else if (arg == "-p") {
+                usePhaseSaving = true;
+            }
+            else if (arg == "-nosimd") {
+                useBitParallel = false;
+            }
+            else if (arg == "-ls" && i + 1 < argc) {
+                useLocalSearch = true;
+                localSearchOptions.algorithm = GetLocalSearchAlgorithm(argv[++i]);
+            }
+            else if (arg == "-flips" && i + 1 < argc) {
+                localSearchOptions.maxFlips = ParseCount(arg, argv[++i]);
+            }
+            else if (arg == "-seed" && i + 1 < argc) {
+                long long seed = ParseCount(arg, argv[++i]);
+
+                if (seed > UINT_MAX)
+                    throw std::string("Invalid value '") + argv[i] + "' of -seed";
+
+                localSearchOptions.seed = seed;
+            }
+            else if (arg == "-hybrid") {
+                localSearchOptions.hybrid = true;
+            }
+            else if (arg == "-t" && i + 1 < argc) {
+                long long count = ParseCount(arg, argv[++i]);
+
+                if (count == 0 || count > INT_MAX)
+                    throw std::string("Invalid value '") + argv[i] + "' of -t";
+
+                threadsCount = count;
+            }
+            else if (arg == "cubes") {
+                useCubes = true;
+            }
+            else if (arg == "batch") {
+                useBatch = true;
+            }
+            else if (arg == "server") {
+                useServer = true;
+            }
+            else if (arg == "-unordered") {
+                serverOrdered = false;
+            }
+            else if (arg == "-f" && i + 1 < argc) {
+                batchFormat = GetBatchFormat(argv[++i]);
+            }
+            else if (arg == "-progress" && i + 1 < argc) {
+                progressInterval = ParseCount(arg, argv[++i]);
+            }
+            else if (arg == "-time" && i + 1 < argc) {
+                limits.time = ParseAmount(arg, argv[++i]);
+            }
+            else if (arg == "-conflicts" && i + 1 < argc) {
+                limits.conflicts = ParseCount(arg, argv[++i]);
+            }
+            else if (arg == "-decisions" && i + 1 < argc) {
+                limits.decisions = ParseCount(arg, argv[++i]);
+            }
+            else if (arg == "-memory" && i + 1 < argc) {
+                limits.memory = (size_t) (ParseAmount(arg, argv[++i]) * (1 << 20));
+            }
+            else if (arg == "-proof" && i + 1 < argc) {
+                proofPath = argv[++i];
+            }
+            else if (arg == "-binary") {
+                binaryProof = true;
+            }
+            else if (arg == "-scaling") {
+                printScaling = true;
+            }
+            else if (arg == "portfolio" && !haveStrategy) {
+                usePortfolio = true;
+                haveStrategy = true;
+            }
             else if (!haveStrategy) {
                 strategy = GetStrategy(arg);
                 haveStrategy = true;
@@ -69,37 +281,241 @@ int main(int argc, char **argv) {
             }
         }
 
-        ifstream fin(argv[1]);
+        string path = argv[1];
+
+        if (!proofPath.empty() && (useBatch || useServer || usePortfolio || useCubes))
+            throw std::string("proof can be written only by a single-threaded search");
+
+        if (useLocalSearch && (useCDCL || usePortfolio || useCubes))
+            throw std::string("local search can not be combined with CDCL, portfolio or cubes");
+
+        bool portfolioBitParallel = useBitParallel; // портфель сам выбирает решатель с движком, -nosimd выключает его и там
+
+        // движок выбирает переменные сам, поэтому подставляется только вместо стратегии по умолчанию
+        useBitParallel = useBitParallel && !haveStrategy;
+        bool mayUseBitParallel = useBitParallel && !useCDCL && !useCubes && proofPath.empty() && (!useLocalSearch || localSearchOptions.hybrid);
+
+        BatchConfiguration configuration = { strategy, useCDCL, restartPolicy, usePhaseSaving, useBitParallel, useLocalSearch, localSearchOptions, removeDuplicates, useSubsumption, useProbing, useElimination, limits, batchFormat };
+
+        if (useServer) {
+            if (usePortfolio || useCubes || useBatch)
+                throw std::string("portfolio, cubes and batch can not be used in server mode");
+
+            SolveServer server(configuration, threadsCount, serverOrdered);
+
+            if (path != "-") {
+                server.Listen(path); // работает до завершения процесса
+                return 0;
+            }
+
+            BatchSummary summary = server.Serve(STDIN_FILENO, STDOUT_FILENO);
+
+            cerr << "Solved " << summary.sat + summary.unsat << " formulas (" << summary.sat << " SAT, " << summary.unsat << " UNSAT, " << summary.unknown << " UNKNOWN, " << summary.errors << " errors) on " << threadsCount << " threads" << endl;
+            cerr << "  Total parse time: " << summary.parseTime << " ms" << endl;
+            cerr << "  Total solve time: " << summary.solveTime << " ms" << endl;
+            cerr << "  Wall time: " << summary.wallTime << " ms (" << (summary.wallTime > 0 ? (summary.sat + summary.unsat + summary.unknown + summary.errors) * 1000.0 / summary.wallTime : 0) << " formulas/s)" << endl;
+            return 0;
+        }
+
+        if (useBatch) {
+            if (usePortfolio)
+                throw std::string("portfolio can not be used in batch mode");
 
-        if (!fin) {
-            cout << "Error: unable to open file '" << argv[1] << "'" << endl;
-            return -1;
+            BatchRunner runner(GetBatchFiles(path), configuration, threadsCount);
+            BatchSummary summary = runner.Run(cout);
+
+            // итоги в поток ошибок, чтобы не смешивать их с результатами
+            cerr << "Solved " << summary.sat + summary.unsat << " files (" << summary.sat << " SAT, " << summary.unsat << " UNSAT, " << summary.unknown << " UNKNOWN, " << summary.errors << " errors) on " << threadsCount << " threads" << endl;
+            cerr << "  Total parse time: " << summary.parseTime << " ms" << endl;
+            cerr << "  Total solve time: " << summary.solveTime << " ms" << endl;
+            cerr << "  Wall time: " << summary.wallTime << " ms (" << (summary.wallTime > 0 ? (summary.sat + summary.unsat + summary.unknown + summary.errors) * 1000.0 / summary.wallTime : 0) << " files/s)" << endl;
+            return 0;
         }
 
         cout << "Run parameters: " << endl;
-        cout << "  Strategy: " << StrategyToString(strategy) << endl;
+        cout << "  Strategy: " << (usePortfolio ? "portfolio (" + to_string(threadsCount) + " threads)" : (mayUseBitParallel ? "bit-parallel engine up to " + to_string(BitParallelSolver::MAX_VARIABLES) + " variables, " + StrategyToString(strategy) + " otherwise" : StrategyToString(strategy))) << endl;
         cout << "  Remove duplicates: " << (removeDuplicates ? "yes" : "no") << endl;
         cout << "  Use subsumption: " << (useSubsumption ? "yes" : "no") << endl;
+        cout << "  Use probing: " << (useProbing ? "yes" : "no") << endl;
+        cout << "  Use variable elimination: " << (useElimination ? "yes" : "no") << endl;
+        cout << "  Algorithm: " << (useCubes ? "DPLL on cubes (" + to_string(threadsCount) + " threads)" : (useCDCL ? "CDCL" : (useLocalSearch ? "local search" : "DPLL"))) << endl;
+        cout << "  Restarts: " << RestartPolicyToString(restartPolicy) << endl;
+        cout << "  Phase saving: " << (usePhaseSaving ? "yes" : "no") << endl;
+
+        if (useLocalSearch)
+            cout << "  Local search: " << LocalSearchAlgorithmToString(localSearchOptions.algorithm) << " (" << (localSearchOptions.maxFlips > 0 ? to_string(localSearchOptions.maxFlips) : "unlimited") << " flips, seed " << localSearchOptions.seed << (localSearchOptions.hybrid ? ", DPLL fallback" : "") << ")" << endl;
+
+        unique_ptr<ProofWriter> proof(proofPath.empty() ? nullptr : new ProofWriter(proofPath, binaryProof));
 
         TimePoint t0 = Time::now();
-        ConjunctiveNormalForm cnf(fin, removeDuplicates, useSubsumption);
-        fin.close();
+        unique_ptr<DimacsReader> reader(path == "-" ? new DimacsReader(cin) : new DimacsReader(path));
+        ConjunctiveNormalForm cnf(*reader, removeDuplicates, useSubsumption, useElimination, useProbing, proof.get());
+        size_t bytesCount = reader->GetBytesCount();
+        reader.reset(); // освобождаем отображение файла до начала решения
         TimePoint t1 = Time::now();
 
-        cout << "  DPLL verdict: ";
+        cnf.SetRestartPolicy(restartPolicy);
+        cnf.SetPhaseSaving(usePhaseSaving);
+        cnf.SetBitParallel(useBitParallel);
+        cnf.SetProgressInterval(progressInterval);
+        cnf.SetLimits(limits);
+
+        string algorithm = usePortfolio ? "Portfolio" : (useCubes ? "Cubes" : (useCDCL ? "CDCL" : (useLocalSearch ? "Local search" : "DPLL")));
+        unique_ptr<Portfolio> portfolio;
+        unique_ptr<CubeAndConquer> cubes;
+        const ConjunctiveNormalForm *solved = &cnf; // формула, на которой получен ответ
+        Verdict verdict;
 
-        if (cnf.DPLL(strategy)) {
-            cout << "SAT" << endl;
+        if (usePortfolio) {
+            portfolio.reset(new Portfolio(cnf, threadsCount, portfolioBitParallel));
+            verdict = portfolio->Solve();
+
+            const PortfolioConfiguration &configuration = portfolio->GetConfiguration(max(portfolio->GetWinner(), 0));
+            solved = &portfolio->GetSolver(max(portfolio->GetWinner(), 0));
+            useCDCL = configuration.useCDCL;
+            usePhaseSaving = configuration.phaseSaving;
+        }
+        else if (useCubes) {
+            cubes.reset(new CubeAndConquer(cnf, threadsCount, strategy));
+            verdict = cubes->Solve();
+            solved = &cubes->GetSolver(max(cubes->GetWinner(), 0));
+            useCDCL = false;
         }
         else {
-            cout << "UNSAT" << endl;
+            cnf.SetInterruptFlag(&interruptRequested);
+            signal(SIGINT, HandleInterrupt);
+
+            if (useLocalSearch)
+                verdict = cnf.LocalSearch(localSearchOptions, strategy);
+            else
+                verdict = useCDCL ? cnf.CDCL(strategy) : cnf.DPLL(strategy);
+
+            signal(SIGINT, SIG_DFL);
         }
 
+        if (proof)
+            proof->Close(); // сброс буфера входит во время решения
+
         TimePoint t2 = Time::now();
 
+        cout << "  " << algorithm << " verdict: " << VerdictToString(verdict);
+
+        if (verdict == Verdict::Unknown && !usePortfolio && !useCubes)
+            cout << " (" << StopReasonToString(solved->GetStopReason()) << ")";
+
+        cout << endl;
+
+        if (solved->WasBitParallel())
+            cout << "  Bit-parallel engine: " << BitParallelInstructionSet(solved->GetVariablesCount()) << endl;
+
+        if (usePortfolio && verdict != Verdict::Unknown)
+            cout << "  Winner: " << PortfolioConfigurationToString(portfolio->GetConfiguration(portfolio->GetWinner()), solved->WasBitParallel()) << endl;
+
+        if (useCubes)
+            cout << "  Solved cubes: " << cubes->GetSolvedCubesCount() << " (" << cubes->GetSplitsCount() << " split off busy threads)" << endl;
+
+        cout << endl;
+        double readSeconds = std::chrono::duration_cast<us>(t1 - t0).count() / 1000000.0;
+        double throughput = readSeconds > 0 ? bytesCount / readSeconds / (1 << 20) : 0;
+
+        cout << "  Reading/preprocessing time: " << (std::chrono::duration_cast<ms>(t1 - t0).count()) << " ms (" << bytesCount << " bytes, " << throughput << " MB/s)" << endl;
+        cout << "  " << algorithm << " time: " << (std::chrono::duration_cast<ms>(t2 - t1).count()) << " ms" << endl;
+
+        if (useCubes && printScaling) {
+            double baseTime = 0;
+
+            cout << endl;
+            cout << "Scaling: " << endl;
+
+            for (int threads = 1; threads <= threadsCount; threads++) {
+                TimePoint start = Time::now();
+                CubeAndConquer scaling(cnf, threads, strategy);
+                scaling.Solve();
+                double time = std::chrono::duration_cast<us>(Time::now() - start).count() / 1000.0;
+
+                if (threads == 1)
+                    baseTime = time;
+
+                cout << "  " << threads << " threads: " << time << " ms (speedup " << (time > 0 ? baseTime / time : 0) << ", " << scaling.GetSolvedCubesCount() << " cubes)" << endl;
+            }
+        }
+
+        const SolverStatistics &solverStatistics = solved->GetSolverStatistics();
+
         cout << endl;
-        cout << "  Reading/preprocessing time: " << (std::chrono::duration_cast<ms>(t1 - t0).count()) << " ms" << endl;
-        cout << "  DPLL time: " << (std::chrono::duration_cast<ms>(t2 - t1).count()) << " ms" << endl;
+        cout << "Solver statistics: " << endl;
+        cout << "  Decisions: " << solverStatistics.decisions << endl;
+        cout << "  Conflicts: " << solverStatistics.conflicts << endl;
+        cout << "  Propagations: " << solverStatistics.propagations << endl;
+        if (solverStatistics.flips > 0)
+            cout << "  Local search flips: " << solverStatistics.flips << endl;
+
+        cout << "  Restarts: " << solverStatistics.restarts;
+
+        if (solverStatistics.restarts > 0)
+            cout << " (every " << solverStatistics.conflicts / solverStatistics.restarts << " conflicts)";
+
+        cout << endl;
+
+        if (solverStatistics.lookAheads > 0)
+            cout << "  Look-ahead probes: " << solverStatistics.lookAheads << " (" << solverStatistics.failedLiterals << " failed literals)" << endl;
+
+        if (useCDCL) {
+            cout << "  Learned clauses: " << solverStatistics.learnedClauses << endl;
+            cout << "  Deleted clauses: " << solverStatistics.deletedClauses << " (" << solverStatistics.reductions << " reductions)" << endl;
+            cout << "  Peak clause database: " << solverStatistics.peakDatabaseBytes / 1024.0 << " KB" << endl;
+        }
+
+#ifdef SOLVER_INSTRUMENTATION
+        const InstrumentationStatistics &instrumentation = solved->GetInstrumentationStatistics();
+        double totalTime = std::chrono::duration_cast<us>(t2 - t1).count() * 1000.0;
+
+        cout << "  Backtracks: " << instrumentation.backtracks << endl;
+        cout << "  Max decision depth: " << instrumentation.maxDepth << endl;
+        cout << "  Clause visits: " << instrumentation.clauseVisits << endl;
+
+        for (int phase = 0; phase < PhasesCount; phase++) {
+            double share = totalTime > 0 ? 100.0 * instrumentation.phaseTimes[phase] / totalTime : 0;
+            cout << "  Time in " << InstrumentedPhaseToString(phase) << ": " << instrumentation.phaseTimes[phase] / 1000000.0 << " ms (" << share << "%, " << instrumentation.phaseCalls[phase] << " calls)" << endl;
+        }
+#endif
+
+        if (usePhaseSaving) {
+            double hitRate = solverStatistics.decisions > 0 ? 100.0 * solverStatistics.savedPhaseDecisions / solverStatistics.decisions : 0;
+            cout << "  Saved phase hits: " << solverStatistics.savedPhaseDecisions << " (" << hitRate << "%)" << endl;
+        }
+
+        if (proof)
+            cout << "  Proof: " << proof->GetAddedCount() << " added, " << proof->GetDeletedCount() << " deleted clauses (" << proof->GetBytesCount() / 1024.0 << " KB, " << (binaryProof ? "binary" : "text") << " DRAT)" << endl;
+
+        if (removeDuplicates || useSubsumption || useProbing || useElimination) {
+            const PreprocessingStatistics &statistics = cnf.GetPreprocessingStatistics();
+
+            cout << endl;
+            cout << "Preprocessing: " << endl;
+            cout << "  Removed duplicates: " << statistics.duplicates << endl;
+            cout << "  Removed tautologies: " << statistics.tautologies << endl;
+
+            if (useSubsumption) {
+                cout << "  Subsumed clauses: " << statistics.subsumed << endl;
+                cout << "  Strengthened clauses: " << statistics.strengthened << endl;
+                cout << "  Subsumption time: " << statistics.subsumptionTime << " ms" << endl;
+            }
+
+            if (useProbing) {
+                cout << "  Equivalent variables: " << statistics.equivalentVariables << endl;
+                cout << "  Failed literals: " << statistics.failedLiterals << endl;
+                cout << "  Fixed variables: " << statistics.fixedVariables << endl;
+                cout << "  Removed variables: " << statistics.equivalentVariables + statistics.fixedVariables << endl;
+                cout << "  Probing time: " << statistics.probingTime << " ms" << endl;
+            }
+
+            if (useElimination) {
+                cout << "  Eliminated variables: " << statistics.eliminatedVariables << endl;
+                cout << "  Eliminated clauses: " << statistics.eliminatedClauses << endl;
+                cout << "  Elimination time: " << statistics.eliminationTime << " ms" << endl;
+            }
+        }
     }
     catch (const string& error) {
         cout << "Error: " << error << endl;